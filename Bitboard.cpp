@@ -0,0 +1,123 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "./Bitboard.h"
+
+// The bits from bit (mod 64) upwards of a word.
+static inline uint64_t maskFrom(size_t bit) { return ~0ull << (bit & 63); }
+
+// The bits below bit (mod 64) of a word, all of them for a multiple of 64.
+static inline uint64_t maskBelow(size_t bit) {
+  return (bit & 63) == 0 ? ~0ull : ~maskFrom(bit);
+}
+
+// The first of the words from begin up to end (sorted by their index) with
+// an index >= index.
+template <typename Iterator>
+static Iterator lowerBound(Iterator begin, Iterator end, size_t index) {
+  while (begin < end) {
+    Iterator middle = begin + (end - begin) / 2;
+    if (middle->index < index) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
+}
+
+// ____________________________________________________________________________
+Bitboard::Bitboard() : _rows(0), _bits(0) {}
+
+// ____________________________________________________________________________
+void Bitboard::reset(size_t rows, size_t bits) {
+  _rows = rows;
+  _bits = bits;
+  _words.assign(rows, std::vector<Word>());
+}
+
+// ____________________________________________________________________________
+void Bitboard::clearAll() {
+  for (std::vector<Word>& row : _words) { row.clear(); }
+}
+
+// ____________________________________________________________________________
+void Bitboard::set(size_t row, size_t bit) {
+  std::vector<Word>& words = _words[row];
+  auto it = lowerBound(words.begin(), words.end(), bit / 64);
+  if (it == words.end() || it->index != bit / 64) {
+    it = words.insert(it, Word{bit / 64, 0});
+  }
+  it->bits |= 1ull << (bit & 63);
+}
+
+// ____________________________________________________________________________
+void Bitboard::clear(size_t row, size_t bit) {
+  std::vector<Word>& words = _words[row];
+  auto it = lowerBound(words.begin(), words.end(), bit / 64);
+  if (it == words.end() || it->index != bit / 64) { return; }
+  it->bits &= ~(1ull << (bit & 63));
+  // A word without bits goes away, so a sparse row stays small.
+  if (it->bits == 0) { words.erase(it); }
+}
+
+// ____________________________________________________________________________
+bool Bitboard::test(size_t row, size_t bit) const {
+  if (row >= _rows || bit >= _bits) { return false; }
+  const std::vector<Word>& words = _words[row];
+  auto it = lowerBound(words.begin(), words.end(), bit / 64);
+  if (it == words.end() || it->index != bit / 64) { return false; }
+  return (it->bits >> (bit & 63)) & 1;
+}
+
+// ____________________________________________________________________________
+size_t Bitboard::find(size_t row, size_t from, size_t to) const {
+  size_t end = std::min(to, _bits);
+  if (row >= _rows || from >= end) { return to; }
+  size_t first = from / 64;
+  size_t last = (end - 1) / 64;
+  // The words which are there, without the bits in front of from in the
+  // first and the ones from end on in the last word.
+  const std::vector<Word>& words = _words[row];
+  for (auto it = lowerBound(words.begin(), words.end(), first);
+       it != words.end() && it->index <= last; ++it) {
+    uint64_t word = it->bits;
+    if (it->index == first) { word &= maskFrom(from); }
+    if (it->index == last) { word &= maskBelow(end); }
+    if (word != 0) { return it->index * 64 + __builtin_ctzll(word); }
+  }
+  return to;
+}
+
+// ____________________________________________________________________________
+bool Bitboard::any(size_t row, size_t from, size_t to) const {
+  return find(row, from, to) < to;
+}
+
+// ____________________________________________________________________________
+size_t Bitboard::count(size_t row, size_t from, size_t to) const {
+  size_t end = std::min(to, _bits);
+  if (row >= _rows || from >= end) { return 0; }
+  size_t first = from / 64;
+  size_t last = (end - 1) / 64;
+  size_t result = 0;
+  const std::vector<Word>& words = _words[row];
+  for (auto it = lowerBound(words.begin(), words.end(), first);
+       it != words.end() && it->index <= last; ++it) {
+    uint64_t word = it->bits;
+    if (it->index == first) { word &= maskFrom(from); }
+    if (it->index == last) { word &= maskBelow(end); }
+    result += __builtin_popcountll(word);
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+size_t Bitboard::rows() const { return _rows; }
+
+// ____________________________________________________________________________
+size_t Bitboard::bits() const { return _bits; }
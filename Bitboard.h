@@ -0,0 +1,60 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// A matrix of bits with one bitset per row, packed into 64 bit words. A
+// range of a row is checked a word at a time with popcount and count
+// trailing zeros, so there is no loop over the single cells. Only the words
+// with a set bit are kept, so the memory grows with the set bits and not
+// with rows * bits.
+class Bitboard {
+ public:
+  // Constructor, an empty board.
+  Bitboard();
+
+  // Starts over with rows rows of bits bits each, all cleared.
+  void reset(size_t rows, size_t bits);
+
+  // Clears all bits, but keeps the size.
+  void clearAll();
+
+  // Sets, clears and reads a single bit.
+  void set(size_t row, size_t bit);
+  void clear(size_t row, size_t bit);
+  bool test(size_t row, size_t bit) const;
+
+  // Returns the first set bit of row in from up to to - 1, or to if there
+  // is none. Rows and bits outside the board count as cleared.
+  size_t find(size_t row, size_t from, size_t to) const;
+
+  // Returns true if a bit of row in from up to to - 1 is set.
+  bool any(size_t row, size_t from, size_t to) const;
+
+  // Returns the amount of set bits of row in from up to to - 1.
+  size_t count(size_t row, size_t from, size_t to) const;
+
+  // Size of the board.
+  size_t rows() const;
+  size_t bits() const;
+
+ private:
+  // A word which isn't 0, bit k of a row is bit k % 64 of its word with
+  // index k / 64.
+  struct Word {
+    size_t index;
+    uint64_t bits;
+  };
+
+  // The words of every row, sorted by their index.
+  std::vector<std::vector<Word>> _words;
+  size_t _rows;
+  size_t _bits;
+};
+
+#endif  // BITBOARD_H_
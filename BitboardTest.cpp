@@ -0,0 +1,48 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include "./Bitboard.h"
+
+// ____________________________________________________________________________
+TEST(BitboardTest, findAndCount) {
+  // Rows of 200 bits span four words, the last one only partly.
+  Bitboard bits;
+  bits.reset(3, 200);
+  bits.set(1, 0);
+  bits.set(1, 63);
+  bits.set(1, 64);
+  bits.set(1, 150);
+  bits.set(1, 199);
+  ASSERT_TRUE(bits.test(1, 150));
+  ASSERT_FALSE(bits.test(0, 150));
+  ASSERT_FALSE(bits.test(3, 0));
+  ASSERT_FALSE(bits.test(1, 200));
+
+  ASSERT_EQ(0u, bits.find(1, 0, 200));
+  ASSERT_EQ(63u, bits.find(1, 1, 200));
+  ASSERT_EQ(64u, bits.find(1, 64, 200));
+  ASSERT_EQ(150u, bits.find(1, 65, 200));
+  // The end of the range isn't part of it.
+  ASSERT_EQ(150u, bits.find(1, 65, 150));
+  ASSERT_EQ(199u, bits.find(1, 151, 1000));
+  ASSERT_EQ(1000u, bits.find(1, 200, 1000));
+  ASSERT_EQ(200u, bits.find(0, 0, 200));
+  ASSERT_EQ(200u, bits.find(2, 0, 200));
+  ASSERT_EQ(7u, bits.find(5, 0, 7));
+  ASSERT_FALSE(bits.any(1, 1, 63));
+  ASSERT_TRUE(bits.any(1, 1, 64));
+
+  ASSERT_EQ(5u, bits.count(1, 0, 200));
+  ASSERT_EQ(2u, bits.count(1, 63, 65));
+  ASSERT_EQ(3u, bits.count(1, 1, 151));
+  ASSERT_EQ(0u, bits.count(1, 65, 150));
+  ASSERT_EQ(0u, bits.count(1, 150, 150));
+
+  bits.clear(1, 64);
+  ASSERT_EQ(150u, bits.find(1, 64, 200));
+  bits.clearAll();
+  ASSERT_EQ(0u, bits.count(1, 0, 200));
+  ASSERT_EQ(3u, bits.rows());
+  ASSERT_EQ(200u, bits.bits());
+}
@@ -0,0 +1,541 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./Board.h"
+#include "./MappedFile.h"
+#include "./Snapshot.h"
+
+// ____________________________________________________________________________
+Board::Board() {
+  _unsatisfied = 0;
+  _width = 0;
+  _height = 0;
+}
+
+// ____________________________________________________________________________
+void Board::load(const Puzzle& puzzle) {
+  size_t n = puzzle.numIsles();
+  _x.resize(n);
+  _y.resize(n);
+  _required.resize(n);
+  _remaining.resize(n);
+  _isleIndex.clear();
+  _isleIndex.reserve(n);
+  _unsatisfied = 0;
+  _width = 0;
+  _height = 0;
+  std::vector<std::pair<size_t, size_t>> points(n);
+  for (size_t i = 0; i < n; i++) {
+    const PuzzleIsle& elem = puzzle.getIsle(i);
+    _x[i] = elem.x;
+    _y[i] = elem.y;
+    _required[i] = elem.value;
+    _remaining[i] = elem.value;
+    if (elem.value != 0) { _unsatisfied++; }
+    _isleIndex[isleKey(elem.x, elem.y)] = i;
+    points[i] = std::pair<size_t, size_t>(elem.x, elem.y);
+    _width = std::max(_width, elem.x + 1);
+    _height = std::max(_height, elem.y + 1);
+  }
+  _components.reset(n);
+
+  // One record for every pair of neighbouring isles, holding how many
+  // bridges connect them.
+  _neighbours = findNeighbours(points);
+  _isleBridges.assign(n, std::array<int, 4>{{-1, -1, -1, -1}});
+  _start.clear();
+  _end.clear();
+  for (size_t i = 0; i < n; i++) {
+    for (Direction direction : {RIGHT, DOWN}) {
+      int other = _neighbours[i][direction];
+      if (other < 0) { continue; }
+      _isleBridges[i][direction] = _start.size();
+      _isleBridges[other][opposite(direction)] = _start.size();
+      _start.push_back(i);
+      _end.push_back(other);
+    }
+  }
+  _count.assign(_start.size(), 0);
+  buildLines();
+  _rowCrossings.reset(2 * _rowYs.size() + 1, _columnXs.size());
+  _columnCrossings.reset(2 * _columnXs.size() + 1, _rowYs.size());
+}
+
+// Sorts the indices in order stably by their key, 16 bits at a time. Keys
+// below 65536 take one counting pass with as many counts as the largest
+// key, larger ones two, so the counts don't grow with the keys.
+static void sortByKey(const std::vector<uint32_t>& keys,
+                      std::vector<uint32_t>* order) {
+  uint32_t largest = 0;
+  for (uint32_t i : *order) { largest = std::max(largest, keys[i]); }
+  std::vector<uint32_t> sorted(order->size());
+  std::vector<size_t> start;
+  int shift = 0;
+  do {
+    size_t digits = std::min<size_t>(0x10000, (largest >> shift) + 1);
+    start.assign(digits + 1, 0);
+    for (uint32_t i : *order) { start[((keys[i] >> shift) & 0xFFFF) + 1]++; }
+    for (size_t k = 0; k < digits; k++) { start[k + 1] += start[k]; }
+    for (uint32_t i : *order) {
+      sorted[start[(keys[i] >> shift) & 0xFFFF]++] = i;
+    }
+    order->swap(sorted);
+    shift += 16;
+  } while (shift < 32 && (largest >> shift) > 0);
+}
+
+// ____________________________________________________________________________
+void Board::buildLines() {
+  // Sorted by x and then stable by y (and the other way round), the isles
+  // of every line end up sorted without comparing them.
+  size_t n = _x.size();
+  _rowIsles.resize(n);
+  for (size_t i = 0; i < n; i++) { _rowIsles[i] = i; }
+  sortByKey(_x, &_rowIsles);
+  sortByKey(_y, &_rowIsles);
+  _columnIsles = _rowIsles;
+  sortByKey(_x, &_columnIsles);
+
+  // The rows and columns with isles and where their isles start, so
+  // nothing grows with the size of the board.
+  _rowYs.clear();
+  _rowStart.clear();
+  for (size_t k = 0; k < n; k++) {
+    uint32_t y = _y[_rowIsles[k]];
+    if (_rowYs.empty() || _rowYs.back() != y) {
+      _rowYs.push_back(y);
+      _rowStart.push_back(k);
+    }
+  }
+  _rowStart.push_back(n);
+  _columnXs.clear();
+  _columnStart.clear();
+  for (size_t k = 0; k < n; k++) {
+    uint32_t x = _x[_columnIsles[k]];
+    if (_columnXs.empty() || _columnXs.back() != x) {
+      _columnXs.push_back(x);
+      _columnStart.push_back(k);
+    }
+  }
+  _columnStart.push_back(n);
+
+  _isleRows.reset(_rowYs.size(), _columnXs.size());
+  _isleColumns.reset(_columnXs.size(), _rowYs.size());
+  for (size_t i = 0; i < n; i++) {
+    size_t row = rank(_rowYs, _y[i]);
+    size_t column = rank(_columnXs, _x[i]);
+    _isleRows.set(row, column);
+    _isleColumns.set(column, row);
+  }
+}
+
+// ____________________________________________________________________________
+size_t Board::rank(const std::vector<uint32_t>& values, size_t v) {
+  return std::lower_bound(values.begin(), values.end(), v) - values.begin();
+}
+
+// ____________________________________________________________________________
+size_t Board::slot(const std::vector<uint32_t>& values, size_t v) {
+  size_t k = rank(values, v);
+  return k < values.size() && values[k] == v ? 2 * k + 1 : 2 * k;
+}
+
+// ____________________________________________________________________________
+size_t Board::numIsles() const { return _x.size(); }
+
+// ____________________________________________________________________________
+size_t Board::numBridges() const { return _start.size(); }
+
+// ____________________________________________________________________________
+Isle Board::isle(size_t i) const { return Isle(this, i); }
+
+// ____________________________________________________________________________
+Bridge Board::bridge(size_t b) const { return Bridge(this, b); }
+
+// ____________________________________________________________________________
+size_t Board::getX(size_t i) const { return _x[i]; }
+
+// ____________________________________________________________________________
+size_t Board::getY(size_t i) const { return _y[i]; }
+
+// ____________________________________________________________________________
+int Board::getRequired(size_t i) const { return _required[i]; }
+
+// ____________________________________________________________________________
+int Board::getRemaining(size_t i) const { return _remaining[i]; }
+
+// ____________________________________________________________________________
+int Board::getNeighbour(size_t i, Direction direction) const {
+  return _neighbours[i][direction];
+}
+
+// ____________________________________________________________________________
+int Board::getBridge(size_t i, Direction direction) const {
+  return _isleBridges[i][direction];
+}
+
+// ____________________________________________________________________________
+size_t Board::getStart(size_t b) const { return _start[b]; }
+
+// ____________________________________________________________________________
+size_t Board::getEnd(size_t b) const { return _end[b]; }
+
+// ____________________________________________________________________________
+int Board::getCount(size_t b) const { return _count[b]; }
+
+// ____________________________________________________________________________
+uint64_t Board::isleKey(size_t x, size_t y) {
+  // x in the upper and y in the lower 32 bits.
+  return (uint64_t(x) << 32) | uint32_t(y);
+}
+
+// ____________________________________________________________________________
+int Board::isleAt(size_t x, size_t y) const {
+  auto it = _isleIndex.find(isleKey(x, y));
+  if (it == _isleIndex.end()) { return -1; }
+  return it->second;
+}
+
+// ____________________________________________________________________________
+int Board::bridgeBetween(size_t a, size_t b) const {
+  if (a == b) { return -1; }
+  if (_x[a] != _x[b] && _y[a] != _y[b]) { return -1; }
+  Direction direction = directionOf(
+      std::pair<size_t, size_t>(_x[a], _y[a]),
+      std::pair<size_t, size_t>(_x[b], _y[b]));
+  if (_neighbours[a][direction] != static_cast<int>(b)) { return -1; }
+  return _isleBridges[a][direction];
+}
+
+// ____________________________________________________________________________
+void Board::markCrossings(size_t b, bool add) {
+  size_t x1 = _x[_start[b]], y1 = _y[_start[b]];
+  size_t x2 = _x[_end[b]], y2 = _y[_end[b]];
+  // Every slot strictly between the (odd) slots of both isles.
+  if (y1 == y2) {
+    size_t row = rank(_rowYs, y1);
+    size_t last = slot(_columnXs, x2);
+    for (size_t s = slot(_columnXs, x1) + 1; s < last; s++) {
+      if (add) {
+        _columnCrossings.set(s, row);
+      } else {
+        _columnCrossings.clear(s, row);
+      }
+    }
+  } else {
+    size_t column = rank(_columnXs, x1);
+    size_t last = slot(_rowYs, y2);
+    for (size_t s = slot(_rowYs, y1) + 1; s < last; s++) {
+      if (add) {
+        _rowCrossings.set(s, column);
+      } else {
+        _rowCrossings.clear(s, column);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool Board::crossesBridge(size_t x1, size_t y1, size_t x2, size_t y2) const {
+  if (x1 > x2) { std::swap(x1, x2); }
+  if (y1 > y2) { std::swap(y1, y2); }
+  // A horizontal line crosses a vertical bridge passing its row in between
+  // x1 and x2, a vertical line the other way round.
+  if (y1 == y2) {
+    return _rowCrossings.any(slot(_rowYs, y1), rank(_columnXs, x1 + 1),
+                             rank(_columnXs, x2));
+  }
+  if (x1 == x2) {
+    return _columnCrossings.any(slot(_columnXs, x1), rank(_rowYs, y1 + 1),
+                                rank(_rowYs, y2));
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Board::crossesBridge(size_t b) const {
+  return crossesBridge(_x[_start[b]], _y[_start[b]], _x[_end[b]],
+                       _y[_end[b]]);
+}
+
+// ____________________________________________________________________________
+bool Board::isleBetween(size_t x1, size_t y1, size_t x2, size_t y2) const {
+  if (x1 > x2) { std::swap(x1, x2); }
+  if (y1 > y2) { std::swap(y1, y2); }
+  // A line without isles has an even slot and no bits at all.
+  if (y1 == y2) {
+    size_t row = slot(_rowYs, y1);
+    return row % 2 == 1 && _isleRows.any(row / 2, rank(_columnXs, x1 + 1),
+                                         rank(_columnXs, x2));
+  }
+  if (x1 == x2) {
+    size_t column = slot(_columnXs, x1);
+    return column % 2 == 1 &&
+           _isleColumns.any(column / 2, rank(_rowYs, y1 + 1),
+                            rank(_rowYs, y2));
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+void Board::changeRemaining(size_t i, int delta) {
+  if (_remaining[i] == 0) { _unsatisfied++; }
+  _remaining[i] += delta;
+  if (_remaining[i] == 0) { _unsatisfied--; }
+}
+
+// ____________________________________________________________________________
+size_t Board::addBridge(size_t b) {
+  size_t checkpoint = _components.checkpoint();
+  _count[b]++;
+  // The first bridge joins the components of both isles and covers the
+  // cells in between.
+  if (_count[b] == 1) {
+    _components.unite(_start[b], _end[b]);
+    markCrossings(b, true);
+  }
+  changeRemaining(_start[b], -1);
+  changeRemaining(_end[b], -1);
+  return checkpoint;
+}
+
+// ____________________________________________________________________________
+void Board::removeBridge(size_t b, size_t checkpoint) {
+  _count[b]--;
+  if (_count[b] == 0) { markCrossings(b, false); }
+  // Bridges go away in reverse order, so the components can simply go back
+  // to the state before.
+  _components.rollback(checkpoint);
+  changeRemaining(_start[b], 1);
+  changeRemaining(_end[b], 1);
+}
+
+// ____________________________________________________________________________
+void Board::clearBridges() {
+  _count.assign(_start.size(), 0);
+  _remaining = _required;
+  _unsatisfied = 0;
+  for (int value : _required) {
+    if (value != 0) { _unsatisfied++; }
+  }
+  _components.reset(_x.size());
+  _rowCrossings.clearAll();
+  _columnCrossings.clearAll();
+}
+
+// ____________________________________________________________________________
+bool Board::loadSolution(const std::string& filename, std::string* error) {
+  MappedFile file;
+  if (!file.open(filename, error)) { return false; }
+  if (!parseSolution(file.begin(), file.end(), error)) {
+    *error = filename + ":" + *error;
+    return false;
+  }
+  return true;
+}
+
+// Writes "line: what: <the line>" to error and returns false.
+static bool lineError(const char* line, const char* end, size_t lineNumber,
+                      const char* what, std::string* error) {
+  *error = std::to_string(lineNumber) + ": " + what + ": " +
+           std::string(line, lineEnd(line, end));
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Board::parseSolution(const char* begin, const char* end,
+                          std::string* error) {
+  // First only count the bridges of every record, the board doesn't change
+  // before the whole file is fine.
+  std::vector<int> counts(_start.size(), 0);
+  std::vector<size_t> lines(_start.size(), 0);
+  size_t lineNumber = 0;
+  for (const char* line = begin; line < end; line = nextLine(line, end)) {
+    lineNumber++;
+    const char* last = lineEnd(line, end);
+    const char* pos = skipBlanks(line, last);
+    if (pos == last || *pos == '#') { continue; }
+    // Every line is: x1, y1, x2, y2.
+    size_t c[4];
+    if (!scanNumbers(pos, last, c, 4)) {
+      return lineError(line, end, lineNumber, "malformed bridge", error);
+    }
+    int a = isleAt(c[0], c[1]);
+    int b = isleAt(c[2], c[3]);
+    if (a < 0 || b < 0) {
+      return lineError(line, end, lineNumber, "no isle", error);
+    }
+    if (a == b || (c[0] != c[2] && c[1] != c[3])) {
+      return lineError(line, end, lineNumber, "not orthogonal", error);
+    }
+    int record = bridgeBetween(a, b);
+    if (record < 0) {
+      return lineError(line, end, lineNumber, "blocked by another isle",
+                       error);
+    }
+    if (++counts[record] > 2) {
+      return lineError(line, end, lineNumber, "more than two bridges",
+                       error);
+    }
+    lines[record] = lineNumber;
+  }
+  size_t horizontal, vertical;
+  if (findCrossing(counts, &horizontal, &vertical)) {
+    *error = std::to_string(lines[horizontal]) +
+             ": bridge crosses the one of line " +
+             std::to_string(lines[vertical]);
+    return false;
+  }
+
+  clearBridges();
+  for (size_t b = 0; b < counts.size(); b++) {
+    for (int k = 0; k < counts[b]; k++) { addBridge(b); }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Board::loadSnapshot(const std::string& filename, Puzzle* puzzle,
+                         std::string* error) {
+  MappedFile file;
+  if (!file.open(filename, error)) { return false; }
+  const uint8_t* bridges;
+  size_t records;
+  if (!readSnapshot(file.begin(), file.end(), puzzle, &bridges, &records,
+                    error)) {
+    *error = filename + ":" + *error;
+    return false;
+  }
+  load(*puzzle);
+  // A snapshot of a puzzle without a game has no bridge records at all.
+  if (records == 0) { return true; }
+  if (records != numBridges()) {
+    *error = filename + ": " + std::to_string(records) +
+             " bridge records instead of " + std::to_string(numBridges());
+    return false;
+  }
+  std::vector<int> counts(records);
+  for (size_t b = 0; b < records; b++) {
+    counts[b] = snapshotBridges(bridges, b);
+    if (counts[b] > 2) {
+      *error = filename + ": record " + std::to_string(b) +
+               ": more than two bridges";
+      return false;
+    }
+  }
+  size_t horizontal, vertical;
+  if (findCrossing(counts, &horizontal, &vertical)) {
+    *error = filename + ": record " + std::to_string(horizontal) +
+             ": bridge crosses record " + std::to_string(vertical);
+    return false;
+  }
+  for (size_t b = 0; b < records; b++) {
+    for (int k = 0; k < counts[b]; k++) { addBridge(b); }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Board::writeSolution(const std::string& filename,
+                          std::string* error) const {
+  std::vector<SolutionRecord> records;
+  for (size_t b = 0; b < numBridges(); b++) {
+    if (_count[b] == 0) { continue; }
+    records.push_back(SolutionRecord{_x[_start[b]], _y[_start[b]],
+                                     _x[_end[b]], _y[_end[b]], _count[b]});
+  }
+  return writeSolutionFile(filename, records, error);
+}
+
+// ____________________________________________________________________________
+bool Board::findCrossing(const std::vector<int>& counts, size_t* horizontal,
+                         size_t* vertical) const {
+  // A horizontal bridge is open strictly between the columns of its isles.
+  // At every column the bridges ending there are closed first, then the
+  // vertical bridges look for an open one strictly between their rows and
+  // then the bridges starting there are opened. There is at most one open
+  // bridge per row, because the records of a row don't overlap.
+  enum Kind { CLOSE = 0, VERTICAL = 1, OPEN = 2 };
+  struct Event {
+    size_t x;
+    Kind kind;
+    size_t bridge;
+    bool operator<(const Event& other) const {
+      return x != other.x ? x < other.x : kind < other.kind;
+    }
+  };
+  std::vector<Event> events;
+  for (size_t b = 0; b < counts.size(); b++) {
+    if (counts[b] == 0) { continue; }
+    if (_y[_start[b]] == _y[_end[b]]) {
+      events.push_back(Event{_x[_start[b]], OPEN, b});
+      events.push_back(Event{_x[_end[b]], CLOSE, b});
+    } else {
+      events.push_back(Event{_x[_start[b]], VERTICAL, b});
+    }
+  }
+  std::sort(events.begin(), events.end());
+  std::map<size_t, size_t> open;
+  for (const Event& event : events) {
+    size_t b = event.bridge;
+    if (event.kind == CLOSE) {
+      open.erase(_y[_start[b]]);
+    } else if (event.kind == OPEN) {
+      open[_y[_start[b]]] = b;
+    } else {
+      auto it = open.upper_bound(_y[_start[b]]);
+      if (it != open.end() && it->first < _y[_end[b]]) {
+        *horizontal = it->second;
+        *vertical = b;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+size_t Board::unsatisfied() const { return _unsatisfied; }
+
+// ____________________________________________________________________________
+size_t Board::components() const { return _components.components(); }
+
+// ____________________________________________________________________________
+bool Board::solved() const {
+  return _unsatisfied == 0 && _components.components() <= 1;
+}
+
+// ____________________________________________________________________________
+size_t Board::getWidth() const { return _width; }
+
+// ____________________________________________________________________________
+size_t Board::getHeight() const { return _height; }
+
+// ____________________________________________________________________________
+const uint32_t* Board::rowBegin(size_t y) const {
+  return _rowIsles.data() + _rowStart[rank(_rowYs, y)];
+}
+
+// ____________________________________________________________________________
+const uint32_t* Board::rowEnd(size_t y) const {
+  // The start of the first row below y.
+  return _rowIsles.data() + _rowStart[rank(_rowYs, y + 1)];
+}
+
+// ____________________________________________________________________________
+const uint32_t* Board::columnBegin(size_t x) const {
+  return _columnIsles.data() + _columnStart[rank(_columnXs, x)];
+}
+
+// ____________________________________________________________________________
+const uint32_t* Board::columnEnd(size_t x) const {
+  return _columnIsles.data() + _columnStart[rank(_columnXs, x + 1)];
+}
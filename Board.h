@@ -0,0 +1,211 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "./Bitboard.h"
+#include "./Neighbours.h"
+#include "./Object.h"
+#include "./Puzzle.h"
+#include "./UnionFind.h"
+
+// The state of a game without ncurses: the isles, the bridges between
+// neighbouring isles and which isles are connected. Everything is kept in
+// contiguous arrays (one per field) owned by value, the isles and bridges
+// are just indices into them. Isle and Bridge are views on one entry.
+class Board {
+ public:
+  // Constructor.
+  Board();
+
+  // Starts over with the isles of the puzzle and no bridges.
+  void load(const Puzzle& puzzle);
+
+  // Amount of isles and of bridge records (pairs of neighbouring isles).
+  size_t numIsles() const;
+  size_t numBridges() const;
+
+  // Views on isle i and bridge record b.
+  Isle isle(size_t i) const;
+  Bridge bridge(size_t b) const;
+
+  // Position of isle i, the amount of bridges it needs and the amount it
+  // still needs (negative if it has too many).
+  size_t getX(size_t i) const;
+  size_t getY(size_t i) const;
+  int getRequired(size_t i) const;
+  int getRemaining(size_t i) const;
+
+  // The nearest isle in the given direction of isle i or -1.
+  int getNeighbour(size_t i, Direction direction) const;
+
+  // The bridge record to that neighbour or -1.
+  int getBridge(size_t i, Direction direction) const;
+
+  // Left/upper and right/lower isle of bridge record b and its amount of
+  // bridges (0, 1 or 2).
+  size_t getStart(size_t b) const;
+  size_t getEnd(size_t b) const;
+  int getCount(size_t b) const;
+
+  // Returns the isle at exactly (x, y) or -1.
+  int isleAt(size_t x, size_t y) const;
+
+  // Returns the bridge record between isles a and b or -1 if they aren't
+  // neighbours.
+  int bridgeBetween(size_t a, size_t b) const;
+
+  // Returns true if the straight line from (x1, y1) to (x2, y2) crosses a
+  // bridge, without counting the cells at both ends. This takes one look
+  // at every 64 rows or columns with isles the line passes.
+  bool crossesBridge(size_t x1, size_t y1, size_t x2, size_t y2) const;
+
+  // Returns true if a bridge on record b would cross another bridge.
+  bool crossesBridge(size_t b) const;
+
+  // Returns true if there is an isle strictly in between (x1, y1) and
+  // (x2, y2), which have to be in the same row or column. Takes as long as
+  // crossesBridge().
+  bool isleBetween(size_t x1, size_t y1, size_t x2, size_t y2) const;
+
+  // Puts one more bridge on record b. Returns the state of the components
+  // before, which removeBridge() needs.
+  size_t addBridge(size_t b);
+
+  // Takes the latest bridge of record b away again. Bridges have to be
+  // removed in the reverse order they were added.
+  void removeBridge(size_t b, size_t checkpoint);
+
+  // Removes all bridges.
+  void clearBridges();
+
+  // Replaces all bridges by the ones of a *.solution file (one line
+  // x1,y1,x2,y2 per bridge). The whole file is checked before anything
+  // changes: every bridge has to connect two neighbouring isles, there are
+  // at most two bridges per pair and no bridges cross. Returns false and
+  // writes a message with the line number to error if not.
+  bool loadSolution(const std::string& filename, std::string* error);
+
+  // The same for the text of a *.solution file from begin up to end.
+  bool parseSolution(const char* begin, const char* end, std::string* error);
+
+  // Starts over with the isles and bridges of a *.hashi snapshot and
+  // copies the isles to puzzle as well. The bridges are checked like the
+  // ones of a solution. Returns false and writes a message to error if the
+  // file isn't a valid snapshot.
+  bool loadSnapshot(const std::string& filename, Puzzle* puzzle,
+                    std::string* error);
+
+  // Writes the bridges in the x1,y1,x2,y2 format of the *.solution files, a
+  // double bridge as two lines.
+  bool writeSolution(const std::string& filename, std::string* error) const;
+
+  // Amount of isles which don't have exactly the bridges they need.
+  size_t unsatisfied() const;
+
+  // Amount of groups of isles which are connected by bridges.
+  size_t components() const;
+
+  // True if every isle has all its bridges and all isles are connected.
+  bool solved() const;
+
+  // Size of the board.
+  size_t getWidth() const;
+  size_t getHeight() const;
+
+  // The isles of row y sorted by x and of column x sorted by y, none for a
+  // line without isles. Takes a binary search over the lines with isles.
+  const uint32_t* rowBegin(size_t y) const;
+  const uint32_t* rowEnd(size_t y) const;
+  const uint32_t* columnBegin(size_t x) const;
+  const uint32_t* columnEnd(size_t x) const;
+
+ private:
+  // Looks for a horizontal and a vertical record with counts > 0 which
+  // cross, with a sweep over the columns. Returns false if there are none.
+  bool findCrossing(const std::vector<int>& counts, size_t* horizontal,
+                    size_t* vertical) const;
+
+  // Sets the cells record b covers in _rowCrossings or _columnCrossings
+  // (or clears them again if add is false).
+  void markCrossings(size_t b, bool add);
+
+  // Counts the remaining bridges of isle i up or down.
+  void changeRemaining(size_t i, int delta);
+
+  // Key of position (x, y) in _isleIndex.
+  static uint64_t isleKey(size_t x, size_t y);
+
+  // Sorts the isles into rows and columns (see rowBegin()).
+  void buildLines();
+
+  // The amount of values below v, which is the rank of v if it is one of
+  // them.
+  static size_t rank(const std::vector<uint32_t>& values, size_t v);
+
+  // The rank of v times 2 plus 1 if v is one of the values, else the rank
+  // times 2 for all positions in between the same two values.
+  static size_t slot(const std::vector<uint32_t>& values, size_t v);
+
+  // The isles.
+  std::vector<uint32_t> _x;
+  std::vector<uint32_t> _y;
+  std::vector<int> _required;
+  std::vector<int> _remaining;
+  std::vector<std::array<int, 4>> _neighbours;
+  std::vector<std::array<int, 4>> _isleBridges;
+
+  // The bridge records, always from left to right or top to bottom.
+  std::vector<uint32_t> _start;
+  std::vector<uint32_t> _end;
+  std::vector<int> _count;
+
+  // All isles by their position (see isleKey()).
+  std::unordered_map<uint64_t, uint32_t> _isleIndex;
+
+  // The isles of the row with rank k (see _rowYs) are
+  // _rowIsles[_rowStart[k]] up to _rowIsles[_rowStart[k + 1] - 1], the same
+  // for the columns.
+  std::vector<size_t> _rowStart;
+  std::vector<uint32_t> _rowIsles;
+  std::vector<size_t> _columnStart;
+  std::vector<uint32_t> _columnIsles;
+
+  // The x of all columns and the y of all rows with isles, sorted. The
+  // bitboards below are indexed by their rank and not by the position, so
+  // they don't grow with the size of the board (see rank() and slot()).
+  std::vector<uint32_t> _columnXs;
+  std::vector<uint32_t> _rowYs;
+
+  // The same isles as bits, bit rank(x) of row rank(y) in _isleRows and
+  // bit rank(y) of column rank(x) in _isleColumns, so a whole line is
+  // scanned word by word.
+  Bitboard _isleRows;
+  Bitboard _isleColumns;
+
+  // The cells covered by bridges: bit rank(x) of row slot(y) in
+  // _rowCrossings is set if a vertical bridge passes row y in column x in
+  // between its isles, bit rank(y) of column slot(x) in _columnCrossings
+  // if a horizontal bridge passes column x in row y. Bridges only lie on
+  // rows and columns with isles, and all rows in between two of them are
+  // passed by the same vertical bridges, so they share one slot. A new
+  // bridge crosses another one exactly if one of these bits lies strictly
+  // between its isles.
+  Bitboard _rowCrossings;
+  Bitboard _columnCrossings;
+
+  size_t _unsatisfied;
+  UnionFind _components;
+  size_t _width;
+  size_t _height;
+};
+
+#endif  // BOARD_H_
@@ -0,0 +1,275 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include "./Board.h"
+#include "./Puzzle.h"
+
+// ____________________________________________________________________________
+TEST(BoardTest, load) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Board board;
+  board.load(puzzle);
+  ASSERT_EQ(5u, board.numIsles());
+  ASSERT_EQ(4u, board.numBridges());
+  ASSERT_EQ(13u, board.getWidth());
+  ASSERT_EQ(8u, board.getHeight());
+  ASSERT_EQ(5u, board.unsatisfied());
+  ASSERT_EQ(5u, board.components());
+  // Row 7 holds (0, 7) and (12, 7), column 9 holds (9, 0) and (9, 3), both
+  // sorted.
+  ASSERT_EQ(2, board.rowEnd(7) - board.rowBegin(7));
+  ASSERT_EQ(12u, board.getX(board.rowBegin(7)[1]));
+  ASSERT_EQ(2, board.columnEnd(9) - board.columnBegin(9));
+  ASSERT_EQ(3u, board.getY(board.columnBegin(9)[1]));
+  ASSERT_EQ(0, board.rowEnd(4) - board.rowBegin(4));
+  // The bridge records go from left to right and from top to bottom.
+  int b = board.bridgeBetween(board.isleAt(9, 0), board.isleAt(0, 0));
+  ASSERT_LE(0, b);
+  ASSERT_EQ(0u, board.bridge(b).getStart().first);
+  ASSERT_EQ(9u, board.bridge(b).getEnd().first);
+  ASSERT_EQ(-1, board.bridgeBetween(board.isleAt(9, 0), board.isleAt(0, 7)));
+  // Loading again starts over.
+  board.addBridge(b);
+  board.load(puzzle);
+  ASSERT_EQ(5u, board.numIsles());
+  ASSERT_EQ(0, board.getCount(b));
+  ASSERT_EQ(3, board.getRemaining(board.isleAt(0, 0)));
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, addAndRemoveBridge) {
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 2);
+  puzzle.addIsle(2, 0, 3);
+  puzzle.addIsle(2, 2, 1);
+  Board board;
+  board.load(puzzle);
+  int top = board.bridgeBetween(board.isleAt(0, 0), board.isleAt(2, 0));
+  int side = board.bridgeBetween(board.isleAt(2, 0), board.isleAt(2, 2));
+  size_t first = board.addBridge(top);
+  size_t second = board.addBridge(top);
+  ASSERT_EQ(2, board.getCount(top));
+  ASSERT_EQ(2u, board.components());
+  ASSERT_EQ(0, board.isle(board.isleAt(0, 0)).getValue());
+  size_t third = board.addBridge(side);
+  ASSERT_TRUE(board.solved());
+  board.removeBridge(side, third);
+  ASSERT_FALSE(board.solved());
+  ASSERT_EQ(2u, board.unsatisfied());
+  board.removeBridge(top, second);
+  board.removeBridge(top, first);
+  ASSERT_EQ(3u, board.components());
+  ASSERT_EQ(3u, board.unsatisfied());
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, parseSolution) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Board board;
+  board.load(puzzle);
+  const char* text = "# (xy.solution)\n0,0,9,0\n9,0,0,0\n0,0,0,7\n"
+                     "9,0,9,3\n0,7,12,7\n";
+  ASSERT_TRUE(board.parseSolution(text, text + strlen(text), &error));
+  ASSERT_TRUE(board.solved());
+  // Every broken line is reported with its number and nothing changes.
+  const char* wrong[] = { "0,0,9,0\n0,0,9\n", "0,0,9,1\n", "0,0,9,3\n",
+                          "0,0,9,0\n0,0,9,0\n9,0,0,0\n" };
+  const char* messages[] = { "2: malformed bridge: 0,0,9",
+                             "1: no isle: 0,0,9,1",
+                             "1: not orthogonal: 0,0,9,3",
+                             "3: more than two bridges: 9,0,0,0" };
+  for (size_t k = 0; k < 4; k++) {
+    ASSERT_FALSE(board.parseSolution(wrong[k], wrong[k] + strlen(wrong[k]),
+                                     &error));
+    ASSERT_EQ(messages[k], error);
+    ASSERT_TRUE(board.solved());
+  }
+  // A solution which builds fine, but doesn't solve the puzzle.
+  const char* partial = "0,0,9,0\n";
+  ASSERT_TRUE(board.parseSolution(partial, partial + strlen(partial),
+                                  &error));
+  ASSERT_EQ(2, board.getRemaining(board.isleAt(9, 0)));
+  ASSERT_FALSE(board.solved());
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, writeSolutionReportsFullDisk) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error)) << error;
+  Board board;
+  board.load(puzzle);
+  board.addBridge(board.bridgeBetween(board.isleAt(0, 0), board.isleAt(9, 0)));
+  ASSERT_FALSE(board.writeSolution("/dev/full", &error));
+  ASSERT_EQ("Error writing file: /dev/full", error);
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, parseSolutionFindsCrossing) {
+  // A plus: the bridge from top to bottom crosses the one from left to right.
+  Puzzle puzzle;
+  puzzle.addIsle(1, 0, 1);
+  puzzle.addIsle(0, 1, 1);
+  puzzle.addIsle(2, 1, 1);
+  puzzle.addIsle(1, 2, 1);
+  Board board;
+  board.load(puzzle);
+  std::string error;
+  const char* text = "# a plus\n1,0,1,2\n0,1,2,1\n";
+  ASSERT_FALSE(board.parseSolution(text, text + strlen(text), &error));
+  ASSERT_EQ("3: bridge crosses the one of line 2", error);
+  ASSERT_FALSE(board.loadSolution("does-not-exist.solution", &error));
+
+  // No bridge over the isle in the middle.
+  Puzzle line;
+  line.addIsle(0, 0, 1);
+  line.addIsle(2, 0, 2);
+  line.addIsle(4, 0, 1);
+  board.load(line);
+  const char* over = "0,0,4,0\n";
+  ASSERT_FALSE(board.parseSolution(over, over + strlen(over), &error));
+  ASSERT_EQ("1: blocked by another isle: 0,0,4,0", error);
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, crossesBridge) {
+  // A plus with an isle on the far right, so the middle row has two records.
+  Puzzle puzzle;
+  puzzle.addIsle(2, 0, 1);
+  puzzle.addIsle(0, 2, 1);
+  puzzle.addIsle(4, 2, 1);
+  puzzle.addIsle(2, 4, 1);
+  puzzle.addIsle(6, 2, 1);
+  Board board;
+  board.load(puzzle);
+  int vertical = board.bridgeBetween(board.isleAt(2, 0), board.isleAt(2, 4));
+  int horizontal = board.bridgeBetween(board.isleAt(0, 2),
+                                       board.isleAt(4, 2));
+  int right = board.bridgeBetween(board.isleAt(4, 2), board.isleAt(6, 2));
+  ASSERT_FALSE(board.crossesBridge(horizontal));
+  size_t checkpoint = board.addBridge(vertical);
+  ASSERT_TRUE(board.crossesBridge(horizontal));
+  ASSERT_FALSE(board.crossesBridge(right));
+  // Touching the bridge at the ends isn't crossing it.
+  ASSERT_FALSE(board.crossesBridge(0, 0, 2, 0));
+  ASSERT_TRUE(board.crossesBridge(3, 1, 1, 1));
+  board.addBridge(vertical);
+  board.removeBridge(vertical, checkpoint + 1);
+  ASSERT_TRUE(board.crossesBridge(horizontal));
+  board.removeBridge(vertical, checkpoint);
+  ASSERT_FALSE(board.crossesBridge(horizontal));
+  // And the other way round.
+  board.addBridge(horizontal);
+  ASSERT_TRUE(board.crossesBridge(vertical));
+  ASSERT_TRUE(board.isleBetween(0, 2, 6, 2));
+  ASSERT_FALSE(board.isleBetween(0, 2, 4, 2));
+  ASSERT_FALSE(board.isleBetween(2, 1, 2, 3));
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, crossesBridgeOnWideBoard) {
+  // Long lines which span many words of the bitboards.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 5, 1);
+  puzzle.addIsle(999, 5, 1);
+  puzzle.addIsle(700, 0, 1);
+  puzzle.addIsle(700, 600, 1);
+  puzzle.addIsle(300, 10, 1);
+  Board board;
+  board.load(puzzle);
+  int horizontal = board.bridgeBetween(board.isleAt(0, 5),
+                                       board.isleAt(999, 5));
+  int vertical = board.bridgeBetween(board.isleAt(700, 0),
+                                     board.isleAt(700, 600));
+  ASSERT_FALSE(board.crossesBridge(vertical));
+  board.addBridge(horizontal);
+  ASSERT_TRUE(board.crossesBridge(vertical));
+  ASSERT_TRUE(board.crossesBridge(700, 0, 700, 6));
+  ASSERT_FALSE(board.crossesBridge(700, 5, 700, 600));
+  ASSERT_FALSE(board.crossesBridge(699, 0, 699, 5));
+  ASSERT_TRUE(board.isleBetween(700, 0, 700, 601));
+  ASSERT_FALSE(board.isleBetween(700, 1, 700, 600));
+  ASSERT_TRUE(board.isleBetween(299, 10, 1000, 10));
+  ASSERT_FALSE(board.isleBetween(0, 10, 300, 10));
+  board.clearBridges();
+  ASSERT_FALSE(board.crossesBridge(vertical));
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, crossesBridgeFarApart) {
+  // Only the rows and columns with isles take room, not the whole board.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(999999, 0, 2);
+  puzzle.addIsle(999999, 999999, 1);
+  puzzle.addIsle(0, 500000, 1);
+  puzzle.addIsle(999999, 500000, 3);
+  Board board;
+  board.load(puzzle);
+  ASSERT_EQ(1000000u, board.getWidth());
+  ASSERT_EQ(1000000u, board.getHeight());
+  int horizontal = board.bridgeBetween(board.isleAt(0, 500000),
+                                       board.isleAt(999999, 500000));
+  int top = board.bridgeBetween(board.isleAt(999999, 0),
+                                board.isleAt(999999, 500000));
+  ASSERT_LE(0, horizontal);
+  ASSERT_LE(0, top);
+  board.addBridge(horizontal);
+  ASSERT_FALSE(board.crossesBridge(top));
+  // Rows and columns without isles in between.
+  ASSERT_TRUE(board.crossesBridge(123456, 1, 123456, 999999));
+  ASSERT_FALSE(board.crossesBridge(123456, 1, 123456, 500000));
+  ASSERT_FALSE(board.crossesBridge(0, 7, 999999, 7));
+  board.addBridge(top);
+  ASSERT_TRUE(board.crossesBridge(0, 7, 1000000, 7));
+  ASSERT_FALSE(board.crossesBridge(0, 7, 999999, 7));
+  ASSERT_TRUE(board.isleBetween(999999, 0, 999999, 999999));
+  ASSERT_FALSE(board.isleBetween(999999, 1, 999999, 500000));
+  ASSERT_FALSE(board.isleBetween(0, 7, 999999, 7));
+  board.clearBridges();
+  ASSERT_FALSE(board.crossesBridge(0, 7, 1000000, 7));
+
+  const char* solution = "0,0,999999,0\n999999,0,999999,500000\n"
+                         "0,500000,999999,500000\n"
+                         "999999,500000,999999,999999\n";
+  std::string error;
+  ASSERT_TRUE(board.parseSolution(solution, solution + strlen(solution),
+                                  &error)) << error;
+  ASSERT_TRUE(board.solved());
+}
+
+// ____________________________________________________________________________
+TEST(BoardTest, linesFarApart) {
+  // The lines are found by their rank, a coordinate near 1e9 takes no more
+  // room than a small one.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(900000000, 0, 2);
+  puzzle.addIsle(900000000, 999999999, 1);
+  Board board;
+  board.load(puzzle);
+  ASSERT_EQ(900000001u, board.getWidth());
+  ASSERT_EQ(1000000000u, board.getHeight());
+  ASSERT_EQ(2, board.rowEnd(0) - board.rowBegin(0));
+  ASSERT_EQ(900000000u, board.getX(board.rowBegin(0)[1]));
+  ASSERT_EQ(2, board.columnEnd(900000000) - board.columnBegin(900000000));
+  ASSERT_EQ(999999999u, board.getY(board.columnBegin(900000000)[1]));
+  // Lines without isles, also outside the board, are empty.
+  ASSERT_EQ(board.rowBegin(5), board.rowEnd(5));
+  ASSERT_EQ(board.columnBegin(1), board.columnEnd(1));
+  ASSERT_EQ(board.rowBegin(2000000000), board.rowEnd(2000000000));
+
+  const char* solution = "0,0,900000000,0\n"
+                         "900000000,0,900000000,999999999\n";
+  std::string error;
+  ASSERT_TRUE(board.parseSolution(solution, solution + strlen(solution),
+                                  &error)) << error;
+  ASSERT_TRUE(board.solved());
+}
@@ -0,0 +1,104 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "./Canvas.h"
+
+// ____________________________________________________________________________
+Canvas::Canvas() {
+  _width = 0;
+  _height = 0;
+  _cellsWritten = 0;
+}
+
+// ____________________________________________________________________________
+void Canvas::reset(size_t width, size_t height) {
+  Cell blank;
+  blank.ch = ' ';
+  blank.color = 0;
+  blank.reverse = false;
+  _width = width;
+  _height = height;
+  _cells.assign(width * height, blank);
+  _isDirty.assign(width * height, 0);
+  _dirty.clear();
+}
+
+// ____________________________________________________________________________
+void Canvas::clear() {
+  for (size_t y = 0; y < _height; y++) {
+    for (size_t x = 0; x < _width; x++) { put(x, y, ' ', 0, false); }
+  }
+}
+
+// ____________________________________________________________________________
+void Canvas::put(long x, long y, char ch, int color, bool reverse) {
+  if (x < 0 || y < 0 || x >= static_cast<long>(_width) ||
+      y >= static_cast<long>(_height)) {
+    return;
+  }
+  size_t i = y * _width + x;
+  Cell& cell = _cells[i];
+  if (cell.ch == ch && cell.color == color && cell.reverse == reverse) {
+    // Nothing changed, so the terminal doesn't need to know.
+    return;
+  }
+  cell.ch = ch;
+  cell.color = color;
+  cell.reverse = reverse;
+  if (!_isDirty[i]) {
+    _isDirty[i] = 1;
+    _dirty.push_back(i);
+  }
+}
+
+// ____________________________________________________________________________
+void Canvas::print(long x, long y, const std::string& text, int color,
+                   bool reverse) {
+  for (size_t i = 0; i < text.size(); i++) {
+    put(x + i, y, text[i], color, reverse);
+  }
+}
+
+// ____________________________________________________________________________
+const Cell& Canvas::get(size_t x, size_t y) const {
+  return _cells[y * _width + x];
+}
+
+// ____________________________________________________________________________
+void Canvas::flush(std::function<void(size_t, size_t, const Cell&)> draw) {
+  for (size_t i : _dirty) {
+    draw(i % _width, i / _width, _cells[i]);
+    _isDirty[i] = 0;
+  }
+  _cellsWritten += _dirty.size();
+  _dirty.clear();
+}
+
+// ____________________________________________________________________________
+size_t Canvas::dirtyCells() const { return _dirty.size(); }
+
+// ____________________________________________________________________________
+size_t Canvas::cellsWritten() const { return _cellsWritten; }
+
+// ____________________________________________________________________________
+std::string Canvas::snapshot() const {
+  std::string text;
+  text.reserve((_width + 1) * _height);
+  for (size_t y = 0; y < _height; y++) {
+    for (size_t x = 0; x < _width; x++) {
+      text += _cells[y * _width + x].ch;
+    }
+    text += '\n';
+  }
+  return text;
+}
+
+// ____________________________________________________________________________
+size_t Canvas::getWidth() const { return _width; }
+
+// ____________________________________________________________________________
+size_t Canvas::getHeight() const { return _height; }
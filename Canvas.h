@@ -0,0 +1,75 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef CANVAS_H_
+#define CANVAS_H_
+
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+// One cell of the screen: a character, its colour pair and whether it is
+// drawn reversed.
+struct Cell {
+  char ch;
+  int color;
+  bool reverse;
+};
+
+// An offscreen copy of the screen. Drawing only changes the buffer and
+// remembers which cells really changed, flush() then hands exactly these
+// cells to the terminal. Without a terminal snapshot() returns the content
+// as text, e.g. for tests and benchmarks.
+class Canvas {
+ public:
+  // Constructor.
+  Canvas();
+
+  // Clears the canvas and sets its size. Nothing is dirty afterwards, the
+  // terminal is expected to be cleared as well.
+  void reset(size_t width, size_t height);
+
+  // Sets every cell back to a blank (changed cells get dirty).
+  void clear();
+
+  // Sets one cell. Cells outside of the canvas are ignored.
+  void put(long x, long y, char ch, int color, bool reverse);
+
+  // Writes text starting at (x, y).
+  void print(long x, long y, const std::string& text, int color,
+             bool reverse);
+
+  // Returns the cell at (x, y).
+  const Cell& get(size_t x, size_t y) const;
+
+  // Calls draw for every cell which changed since the last flush.
+  void flush(std::function<void(size_t, size_t, const Cell&)> draw);
+
+  // Returns the amount of cells waiting for flush().
+  size_t dirtyCells() const;
+
+  // Returns the amount of cells flush() has written so far.
+  size_t cellsWritten() const;
+
+  // Returns the characters of the canvas, one line per row.
+  std::string snapshot() const;
+
+  size_t getWidth() const;
+  size_t getHeight() const;
+
+ private:
+  size_t _width;
+  size_t _height;
+
+  // All cells row by row.
+  std::vector<Cell> _cells;
+
+  // Indices of the changed cells and a flag per cell to find them fast.
+  std::vector<size_t> _dirty;
+  std::vector<char> _isDirty;
+
+  size_t _cellsWritten;
+};
+
+#endif  // CANVAS_H_
@@ -0,0 +1,39 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <string>
+#include "./Canvas.h"
+
+// ____________________________________________________________________________
+TEST(CanvasTest, onlyChangedCellsAreDirty) {
+  Canvas canvas;
+  canvas.reset(4, 2);
+  ASSERT_EQ(0u, canvas.dirtyCells());
+  canvas.put(1, 0, 'x', 2, false);
+  canvas.put(1, 0, 'x', 2, false);
+  // Writing a blank on a blank cell changes nothing.
+  canvas.put(0, 1, ' ', 0, false);
+  // Outside of the canvas.
+  canvas.put(4, 0, 'y', 2, false);
+  ASSERT_EQ(1u, canvas.dirtyCells());
+  canvas.print(1, 1, "ab", 1, true);
+  ASSERT_EQ(3u, canvas.dirtyCells());
+  ASSERT_EQ(" x  \n ab \n", canvas.snapshot());
+}
+
+// ____________________________________________________________________________
+TEST(CanvasTest, flush) {
+  Canvas canvas;
+  canvas.reset(3, 3);
+  canvas.put(2, 1, 'H', 2, false);
+  canvas.put(0, 2, '3', 1, true);
+  std::string drawn;
+  canvas.flush([&drawn](size_t x, size_t y, const Cell& cell) {
+    drawn += std::to_string(x) + std::to_string(y) + cell.ch;
+  });
+  ASSERT_EQ("21H023", drawn);
+  ASSERT_EQ(0u, canvas.dirtyCells());
+  ASSERT_EQ(2u, canvas.cellsWritten());
+  canvas.flush([](size_t, size_t, const Cell&) { FAIL(); });
+}
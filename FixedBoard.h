@@ -0,0 +1,506 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef FIXEDBOARD_H_
+#define FIXEDBOARD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "./MappedFile.h"
+#include "./Neighbours.h"
+#include "./Puzzle.h"
+
+// A board and solver for puzzles of at most W x H cells and N isles. All
+// sizes are known at compile time, so everything lives in std::array and
+// std::bitset members and nothing is allocated while checking or solving.
+// It knows less than Board and Solver (no undo, no parallel search, no
+// messages), the dynamic ones take over for everything else and for
+// puzzles which are too large (see visitFixedBoard()).
+template <size_t W, size_t H, size_t N>
+class FixedBoard {
+  static_assert(W > 0 && H > 0, "the board needs at least one cell");
+  static_assert(W <= 256 && H <= 256, "positions have to fit into 8 bits");
+  static_assert(N > 0 && N <= W * H, "at most one isle per cell");
+  static_assert(2 * N < 0xFFFF, "isles and edges have to fit into 16 bits");
+
+ public:
+  // Amount of cells and the most edges the isles can have: every isle
+  // starts at most one edge to the right and one downwards.
+  static constexpr size_t kCells = W * H;
+  static constexpr size_t kMaxEdges = 2 * N;
+
+  // Returns true if a puzzle of that size fits.
+  static constexpr bool fits(size_t width, size_t height, size_t isles) {
+    return width <= W && height <= H && isles <= N;
+  }
+
+  // Constructor, an empty board.
+  FixedBoard() : _numIsles(0), _numEdges(0), _trailSize(0), _nodes(0) {}
+
+  // Takes the isles of the puzzle and finds their edges. Returns false if
+  // the puzzle doesn't fit or two isles share a cell.
+  bool load(const Puzzle& puzzle);
+
+  // Puts the bridges of the text of a *.solution file onto the board.
+  // Returns false if the file isn't valid, Board::parseSolution() tells
+  // what is wrong with it.
+  bool parseSolution(const char* begin, const char* end);
+
+  // Amount of isles without the right amount of bridges and of groups of
+  // isles connected by the bridges.
+  size_t unsatisfied() const;
+  size_t components() const;
+
+  // True if every isle has all its bridges and all isles are connected.
+  bool solved() const;
+
+  // Propagates the isle values like Solver and searches depth first for
+  // the rest. Returns true if a solution was found, getBridges() holds it.
+  bool solve();
+
+  // Amount of search nodes the last solve() needed.
+  size_t getNodes() const { return _nodes; }
+
+  // Amount of edges, their isles and their bridges after solve() or
+  // parseSolution().
+  size_t numEdges() const { return _numEdges; }
+  size_t getStart(size_t e) const { return _start[e]; }
+  size_t getEnd(size_t e) const { return _end[e]; }
+  int getBridges(size_t e) const { return _count[e]; }
+
+  // Writes the bridges in the x1,y1,x2,y2 format of the *.solution files.
+  bool writeSolution(const std::string& filename, std::string* error) const;
+
+ private:
+  static const uint16_t kNone = 0xFFFF;
+
+  // One bound change of the search, so it can be taken back.
+  struct TrailEntry {
+    uint16_t edge;
+    int8_t lo;
+    int8_t hi;
+  };
+
+  // One decision of the search.
+  struct Frame {
+    uint16_t edge;
+    int8_t value;
+    size_t trail;
+  };
+
+  // Index of cell (x, y).
+  static size_t cell(size_t x, size_t y) { return y * W + x; }
+
+  // Adds the edge from isle i to the next isle in direction (RIGHT or
+  // DOWN), if there is one.
+  void addEdge(size_t i, Direction direction);
+
+  // Calls f(other) for every edge which crosses edge e.
+  template <typename F>
+  void forCrossings(size_t e, F f) const;
+
+  // Returns true if the edges with _count > 0 connect all isles, the
+  // amount of groups is written to groups if it isn't null.
+  bool countGroups(bool bounds, size_t* groups) const;
+
+  // Narrows the bounds of edge e and excludes the crossing edges if it
+  // gets a bridge for sure. Returns false on a contradiction.
+  bool setBounds(size_t e, int lo, int hi);
+
+  // Checks the edges around isle i against its value.
+  bool propagateIsle(size_t i);
+
+  // Runs propagateIsle() until the queue is empty.
+  bool propagate();
+
+  // Takes back all bound changes until the trail has the given size.
+  void undoTo(size_t size);
+
+  // The isles: position, value and the edge in every Direction.
+  size_t _numIsles;
+  std::array<uint8_t, N> _x;
+  std::array<uint8_t, N> _y;
+  std::array<uint8_t, N> _value;
+  std::array<std::array<uint16_t, 4>, N> _incident;
+
+  // The isle on every cell, and the horizontal and vertical edge which
+  // passes every cell in between its isles (kNone if there is none).
+  std::array<uint16_t, kCells> _isleAt;
+  std::array<uint16_t, kCells> _horizontalAt;
+  std::array<uint16_t, kCells> _verticalAt;
+
+  // The edges, from left to right or top to bottom, and their bridges.
+  size_t _numEdges;
+  std::array<uint16_t, kMaxEdges> _start;
+  std::array<uint16_t, kMaxEdges> _end;
+  std::array<int8_t, kMaxEdges> _count;
+
+  // The bounds of the search. Every change narrows one edge from at most
+  // [0, 2], so there are at most two changes per edge on the trail.
+  std::array<int8_t, kMaxEdges> _lo;
+  std::array<int8_t, kMaxEdges> _hi;
+  std::array<TrailEntry, 2 * kMaxEdges> _trail;
+  size_t _trailSize;
+  std::array<Frame, kMaxEdges> _frames;
+
+  // Isles which have to be checked again.
+  std::array<uint16_t, N> _queue;
+  size_t _queueSize;
+  std::bitset<N> _queued;
+
+  size_t _nodes;
+};
+
+template <size_t W, size_t H, size_t N>
+constexpr size_t FixedBoard<W, H, N>::kCells;
+template <size_t W, size_t H, size_t N>
+constexpr size_t FixedBoard<W, H, N>::kMaxEdges;
+template <size_t W, size_t H, size_t N>
+const uint16_t FixedBoard<W, H, N>::kNone;
+
+// Calls (*visitor)(board) with a FixedBoard of the smallest size below
+// which fits the puzzle, loaded with it, and returns true. Returns false
+// without calling it if the puzzle needs the dynamic Board and Solver.
+template <typename Visitor>
+bool visitFixedBoard(const Puzzle& puzzle, Visitor* visitor);
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::load(const Puzzle& puzzle) {
+  if (!fits(puzzle.getWidth(), puzzle.getHeight(), puzzle.numIsles())) {
+    return false;
+  }
+  _numIsles = puzzle.numIsles();
+  _isleAt.fill(kNone);
+  _horizontalAt.fill(kNone);
+  _verticalAt.fill(kNone);
+  for (size_t i = 0; i < _numIsles; i++) {
+    const PuzzleIsle& isle = puzzle.getIsle(i);
+    if (isle.x >= W || isle.y >= H || _isleAt[cell(isle.x, isle.y)] != kNone) {
+      return false;
+    }
+    _x[i] = isle.x;
+    _y[i] = isle.y;
+    _value[i] = isle.value;
+    _incident[i].fill(kNone);
+    _isleAt[cell(isle.x, isle.y)] = i;
+  }
+  // The same order of edges as the records of Board.
+  _numEdges = 0;
+  for (size_t i = 0; i < _numIsles; i++) {
+    addEdge(i, RIGHT);
+    addEdge(i, DOWN);
+  }
+  _count.fill(0);
+  return true;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+void FixedBoard<W, H, N>::addEdge(size_t i, Direction direction) {
+  size_t dx = direction == RIGHT ? 1 : 0;
+  size_t dy = 1 - dx;
+  size_t x = _x[i] + dx;
+  size_t y = _y[i] + dy;
+  while (x < W && y < H && _isleAt[cell(x, y)] == kNone) {
+    x += dx;
+    y += dy;
+  }
+  if (x >= W || y >= H) { return; }
+  size_t other = _isleAt[cell(x, y)];
+  size_t e = _numEdges++;
+  _start[e] = i;
+  _end[e] = other;
+  _incident[i][direction] = e;
+  _incident[other][opposite(direction)] = e;
+  std::array<uint16_t, kCells>& at =
+      direction == RIGHT ? _horizontalAt : _verticalAt;
+  for (size_t cx = _x[i] + dx, cy = _y[i] + dy; cx != x || cy != y;
+       cx += dx, cy += dy) {
+    at[cell(cx, cy)] = e;
+  }
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+template <typename F>
+void FixedBoard<W, H, N>::forCrossings(size_t e, F f) const {
+  size_t s = _start[e];
+  size_t t = _end[e];
+  if (_y[s] == _y[t]) {
+    for (size_t x = _x[s] + 1; x < _x[t]; x++) {
+      uint16_t other = _verticalAt[cell(x, _y[s])];
+      if (other != kNone) { f(other); }
+    }
+  } else {
+    for (size_t y = _y[s] + 1; y < _y[t]; y++) {
+      uint16_t other = _horizontalAt[cell(_x[s], y)];
+      if (other != kNone) { f(other); }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::parseSolution(const char* begin, const char* end) {
+  _count.fill(0);
+  for (const char* line = begin; line < end; line = nextLine(line, end)) {
+    const char* last = lineEnd(line, end);
+    const char* pos = skipBlanks(line, last);
+    if (pos == last || *pos == '#') { continue; }
+    size_t c[4];
+    if (!scanNumbers(pos, last, c, 4)) { return false; }
+    if (c[0] >= W || c[2] >= W || c[1] >= H || c[3] >= H) { return false; }
+    if (c[0] != c[2] && c[1] != c[3]) { return false; }
+    if (c[0] > c[2] || c[1] > c[3]) {
+      std::swap(c[0], c[2]);
+      std::swap(c[1], c[3]);
+    }
+    uint16_t a = _isleAt[cell(c[0], c[1])];
+    uint16_t b = _isleAt[cell(c[2], c[3])];
+    if (a == kNone || b == kNone || a == b) { return false; }
+    Direction direction = c[1] == c[3] ? RIGHT : DOWN;
+    uint16_t e = _incident[a][direction];
+    if (e == kNone || _end[e] != b || ++_count[e] > 2) { return false; }
+  }
+  for (size_t e = 0; e < _numEdges; e++) {
+    if (_count[e] == 0) { continue; }
+    bool crosses = false;
+    forCrossings(e, [this, &crosses](size_t other) {
+      if (_count[other] > 0) { crosses = true; }
+    });
+    if (crosses) { return false; }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+size_t FixedBoard<W, H, N>::unsatisfied() const {
+  size_t result = 0;
+  for (size_t i = 0; i < _numIsles; i++) {
+    int sum = 0;
+    for (uint16_t e : _incident[i]) {
+      if (e != kNone) { sum += _count[e]; }
+    }
+    if (sum != _value[i]) { result++; }
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::countGroups(bool bounds, size_t* groups) const {
+  // Depth first search over the edges with bridges (or with hi > 0 if
+  // bounds is true), one search per group.
+  std::bitset<N> visited;
+  std::array<uint16_t, N> stack;
+  size_t result = 0;
+  for (size_t first = 0; first < _numIsles; first++) {
+    if (visited[first]) { continue; }
+    if (++result > 1 && groups == nullptr) { return false; }
+    visited[first] = true;
+    size_t size = 0;
+    stack[size++] = first;
+    while (size > 0) {
+      size_t i = stack[--size];
+      for (uint16_t e : _incident[i]) {
+        if (e == kNone || (bounds ? _hi[e] : _count[e]) == 0) { continue; }
+        size_t other = _start[e] == i ? _end[e] : _start[e];
+        if (visited[other]) { continue; }
+        visited[other] = true;
+        stack[size++] = other;
+      }
+    }
+  }
+  if (groups != nullptr) { *groups = result; }
+  return result <= 1;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+size_t FixedBoard<W, H, N>::components() const {
+  size_t groups;
+  countGroups(false, &groups);
+  return groups;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::solved() const {
+  return unsatisfied() == 0 && countGroups(false, nullptr);
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::setBounds(size_t e, int lo, int hi) {
+  if (lo > hi) { return false; }
+  if (lo == _lo[e] && hi == _hi[e]) { return true; }
+  bool built = lo > 0 && _lo[e] == 0;
+  _trail[_trailSize++] = TrailEntry{static_cast<uint16_t>(e), _lo[e], _hi[e]};
+  _lo[e] = lo;
+  _hi[e] = hi;
+  for (size_t i : {_start[e], _end[e]}) {
+    if (!_queued[i]) {
+      _queued[i] = true;
+      _queue[_queueSize++] = i;
+    }
+  }
+  // A bridge for sure rules out every edge it crosses.
+  bool ok = true;
+  if (built) {
+    forCrossings(e, [this, &ok](size_t other) {
+      if (ok) { ok = setBounds(other, _lo[other], 0); }
+    });
+  }
+  return ok;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::propagateIsle(size_t i) {
+  int sumLo = 0;
+  int sumHi = 0;
+  for (uint16_t e : _incident[i]) {
+    if (e == kNone) { continue; }
+    sumLo += _lo[e];
+    sumHi += _hi[e];
+  }
+  int value = _value[i];
+  if (sumLo > value || sumHi < value) { return false; }
+  // The other edges take at most sumHi - hi, so this one needs the rest,
+  // and it can take no more than what the others leave.
+  for (uint16_t e : _incident[i]) {
+    if (e == kNone) { continue; }
+    int lo = std::max<int>(_lo[e], value - (sumHi - _hi[e]));
+    int hi = std::min<int>(_hi[e], value - (sumLo - _lo[e]));
+    if (!setBounds(e, lo, hi)) { return false; }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::propagate() {
+  while (_queueSize > 0) {
+    size_t i = _queue[--_queueSize];
+    _queued[i] = false;
+    if (!propagateIsle(i)) {
+      _queueSize = 0;
+      _queued.reset();
+      return false;
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+void FixedBoard<W, H, N>::undoTo(size_t size) {
+  while (_trailSize > size) {
+    const TrailEntry& entry = _trail[--_trailSize];
+    _lo[entry.edge] = entry.lo;
+    _hi[entry.edge] = entry.hi;
+  }
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::solve() {
+  _nodes = 0;
+  _trailSize = 0;
+  _queueSize = 0;
+  _queued.reset();
+  for (size_t e = 0; e < _numEdges; e++) {
+    _lo[e] = 0;
+    _hi[e] = std::min<int>(2, std::min(_value[_start[e]], _value[_end[e]]));
+  }
+  for (size_t i = 0; i < _numIsles; i++) {
+    _queued[i] = true;
+    _queue[_queueSize++] = i;
+  }
+  bool ok = propagate() && countGroups(true, nullptr);
+  // Every frame decides one edge, trying its values from the highest to
+  // the lowest. A frame which runs out of values is taken off the stack.
+  size_t depth = 0;
+  size_t next = 0;
+  while (ok) {
+    while (next < _numEdges && _lo[next] == _hi[next]) { next++; }
+    if (next == _numEdges) {
+      for (size_t e = 0; e < _numEdges; e++) { _count[e] = _lo[e]; }
+      return true;
+    }
+    _frames[depth++] = Frame{static_cast<uint16_t>(next), _hi[next],
+                             _trailSize};
+    while (true) {
+      Frame& frame = _frames[depth - 1];
+      _nodes++;
+      if (setBounds(frame.edge, frame.value, frame.value) && propagate() &&
+          countGroups(true, nullptr)) {
+        break;
+      }
+      _queueSize = 0;
+      _queued.reset();
+      // Back to the deepest frame with a value left.
+      while (true) {
+        Frame& last = _frames[depth - 1];
+        undoTo(last.trail);
+        if (last.value > _lo[last.edge]) {
+          last.value--;
+          break;
+        }
+        if (--depth == 0) { return false; }
+      }
+    }
+    // The edges in front of the deepest frame were decided when it was
+    // pushed, a step back only takes back what came after.
+    next = _frames[depth - 1].edge;
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+template <size_t W, size_t H, size_t N>
+bool FixedBoard<W, H, N>::writeSolution(const std::string& filename,
+                                        std::string* error) const {
+  std::vector<SolutionRecord> records;
+  for (size_t e = 0; e < _numEdges; e++) {
+    if (_count[e] == 0) { continue; }
+    size_t s = _start[e];
+    size_t t = _end[e];
+    records.push_back(SolutionRecord{_x[s], _y[s], _x[t], _y[t], _count[e]});
+  }
+  return writeSolutionFile(filename, records, error);
+}
+
+// Loads the puzzle into a FixedBoard<W, H, N> on the stack and hands it to
+// the visitor, if it fits.
+template <size_t W, size_t H, size_t N, typename Visitor>
+bool visitFixedBoardOfSize(const Puzzle& puzzle, Visitor* visitor) {
+  if (!FixedBoard<W, H, N>::fits(puzzle.getWidth(), puzzle.getHeight(),
+                                 puzzle.numIsles())) {
+    return false;
+  }
+  FixedBoard<W, H, N> board;
+  if (!board.load(puzzle)) { return false; }
+  (*visitor)(&board);
+  return true;
+}
+
+// ____________________________________________________________________________
+template <typename Visitor>
+bool visitFixedBoard(const Puzzle& puzzle, Visitor* visitor) {
+  // The shipped instances have at most 13 x 8 cells, the generated ones
+  // are often larger. At most every other cell can hold an isle.
+  return visitFixedBoardOfSize<8, 8, 32>(puzzle, visitor) ||
+         visitFixedBoardOfSize<16, 16, 128>(puzzle, visitor) ||
+         visitFixedBoardOfSize<32, 32, 512>(puzzle, visitor);
+}
+
+#endif  // FIXEDBOARD_H_
@@ -0,0 +1,172 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <glob.h>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "./Board.h"
+#include "./FixedBoard.h"
+#include "./Generator.h"
+#include "./Puzzle.h"
+
+static_assert(FixedBoard<8, 8, 32>::fits(8, 8, 32), "fits exactly");
+static_assert(!FixedBoard<8, 8, 32>::fits(13, 8, 5), "too wide");
+static_assert(FixedBoard<16, 16, 128>::kMaxEdges == 256, "two per isle");
+
+// Solves the puzzle on the board it gets and keeps what it found.
+struct SolveVisitor {
+  size_t cells;
+  bool solved;
+  std::vector<size_t> start;
+  std::vector<size_t> end;
+  std::vector<int> bridges;
+
+  template <typename FixedBoardType>
+  void operator()(FixedBoardType* board) {
+    cells = FixedBoardType::kCells;
+    solved = board->solve();
+    for (size_t e = 0; e < board->numEdges(); e++) {
+      start.push_back(board->getStart(e));
+      end.push_back(board->getEnd(e));
+      bridges.push_back(board->getBridges(e));
+    }
+  }
+};
+
+// Solves the puzzle on a FixedBoard and checks the bridges on a Board.
+static void solveAndCheck(const Puzzle& puzzle, size_t cells) {
+  SolveVisitor visitor = {0, false, {}, {}, {}};
+  ASSERT_TRUE(visitFixedBoard(puzzle, &visitor));
+  ASSERT_EQ(cells, visitor.cells);
+  ASSERT_TRUE(visitor.solved);
+  Board board;
+  board.load(puzzle);
+  // The edges are the records of the Board in the same order.
+  ASSERT_EQ(board.numBridges(), visitor.bridges.size());
+  for (size_t b = 0; b < board.numBridges(); b++) {
+    ASSERT_EQ(board.getStart(b), visitor.start[b]);
+    ASSERT_EQ(board.getEnd(b), visitor.end[b]);
+    for (int k = 0; k < visitor.bridges[b]; k++) {
+      ASSERT_FALSE(board.crossesBridge(b));
+      board.addBridge(b);
+    }
+  }
+  ASSERT_TRUE(board.solved());
+}
+
+// ____________________________________________________________________________
+TEST(FixedBoardTest, solve) {
+  glob_t files;
+  ASSERT_EQ(0, glob("i0*.xy", 0, NULL, &files));
+  for (size_t k = 0; k < files.gl_pathc; k++) {
+    Puzzle puzzle;
+    std::string error;
+    ASSERT_TRUE(puzzle.load(files.gl_pathv[k], &error));
+    SCOPED_TRACE(files.gl_pathv[k]);
+    bool small = puzzle.getWidth() <= 8 && puzzle.getHeight() <= 8;
+    solveAndCheck(puzzle, small ? 64 : 256);
+  }
+  globfree(&files);
+
+  // Generated puzzles which need the largest size.
+  Generator generator(30, 25, 0.15);
+  for (uint64_t seed = 1; seed <= 10; seed++) {
+    Puzzle puzzle;
+    ASSERT_TRUE(generator.generate(seed, &puzzle));
+    SCOPED_TRACE(seed);
+    solveAndCheck(puzzle, 1024);
+  }
+
+  // Nothing fits a board of 40 columns, and an isle with nothing to connect
+  // has no solution.
+  Puzzle wide;
+  wide.addIsle(0, 0, 1);
+  wide.addIsle(39, 0, 1);
+  SolveVisitor visitor = {0, false, {}, {}, {}};
+  ASSERT_FALSE(visitFixedBoard(wide, &visitor));
+  Puzzle lonely;
+  lonely.addIsle(0, 0, 1);
+  lonely.addIsle(1, 1, 1);
+  ASSERT_TRUE(visitFixedBoard(lonely, &visitor));
+  ASSERT_FALSE(visitor.solved);
+}
+
+// Checks the text of a solution on the board it gets.
+struct CheckVisitor {
+  const char* text;
+  bool valid;
+  size_t unsatisfied;
+  size_t components;
+
+  template <typename FixedBoardType>
+  void operator()(FixedBoardType* board) {
+    valid = board->parseSolution(text, text + strlen(text));
+    unsatisfied = board->unsatisfied();
+    components = board->components();
+  }
+};
+
+// ____________________________________________________________________________
+TEST(FixedBoardTest, parseSolution) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  CheckVisitor check = {"# solution\n0,0,9,0\n9,0,0,0\n0,0,0,7\n9,0,9,3\n"
+                        "12,7,0,7\n", false, 0, 0};
+  ASSERT_TRUE(visitFixedBoard(puzzle, &check));
+  ASSERT_TRUE(check.valid);
+  ASSERT_EQ(0u, check.unsatisfied);
+  ASSERT_EQ(1u, check.components);
+
+  check.text = "0,0,9,0\n";
+  visitFixedBoard(puzzle, &check);
+  ASSERT_TRUE(check.valid);
+  ASSERT_EQ(5u, check.unsatisfied);
+  ASSERT_EQ(4u, check.components);
+
+  // Everything Board::parseSolution() rejects.
+  for (const char* text : {"0,0,9\n", "1,0,9,0\n", "0,0,12,7\n",
+                           "0,0,0,0\n", "0,0,12,0\n", "0,0,100,0\n",
+                           "0,0,9,0\n0,0,9,0\n0,0,9,0\n"}) {
+    check.text = text;
+    visitFixedBoard(puzzle, &check);
+    ASSERT_FALSE(check.valid) << text;
+  }
+
+  // A plus with both bridges crosses.
+  Puzzle plus;
+  plus.addIsle(1, 0, 1);
+  plus.addIsle(0, 1, 1);
+  plus.addIsle(2, 1, 1);
+  plus.addIsle(1, 2, 1);
+  check.text = "1,0,1,2\n0,1,2,1\n";
+  ASSERT_TRUE(visitFixedBoard(plus, &check));
+  ASSERT_FALSE(check.valid);
+  check.text = "1,0,1,2\n";
+  visitFixedBoard(plus, &check);
+  ASSERT_TRUE(check.valid);
+  ASSERT_EQ(2u, check.unsatisfied);
+  ASSERT_EQ(3u, check.components);
+}
+
+// ____________________________________________________________________________
+TEST(FixedBoardTest, writeSolution) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error)) << error;
+  FixedBoard<16, 16, 128> board;
+  ASSERT_TRUE(board.load(puzzle));
+  ASSERT_TRUE(board.solve());
+  const char* filename = "/tmp/FixedBoardTest.solution";
+  ASSERT_TRUE(board.writeSolution(filename, &error)) << error;
+  // The same lines the other boards write, which Board reads back.
+  Board check;
+  check.load(puzzle);
+  ASSERT_TRUE(check.loadSolution(filename, &error)) << error;
+  ASSERT_TRUE(check.solved());
+  remove(filename);
+  ASSERT_FALSE(board.writeSolution("/dev/full", &error));
+  ASSERT_EQ("Error writing file: /dev/full", error);
+}
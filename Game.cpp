@@ -0,0 +1,109 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <string>
+#include "./Board.h"
+#include "./Game.h"
+#include "./Snapshot.h"
+
+// ____________________________________________________________________________
+Game::Game() {}
+
+// ____________________________________________________________________________
+bool Game::load(const std::string& filename, int undos, std::string* error) {
+  // The file is scanned in place by Puzzle, which also tells us the line of
+  // a malformed isle instead of throwing out of stoi. A snapshot brings its
+  // bridges along.
+  const std::string ending = ".hashi";
+  bool ok;
+  if (filename.size() >= ending.size() &&
+      filename.compare(filename.size() - ending.size(), ending.size(),
+                       ending) == 0) {
+    ok = _board.loadSnapshot(filename, &_puzzle, error);
+  } else {
+    ok = _puzzle.load(filename, error);
+    if (ok) { _board.load(_puzzle); }
+  }
+  if (!ok) { return false; }
+  _hints.reset(_board);
+  _journal.reset(undos < 0 ? Journal<Move>::kUnlimited : undos);
+  return true;
+}
+
+// ____________________________________________________________________________
+int Game::build(size_t startX, size_t startY, size_t endX, size_t endY) {
+  int bridge = bridgeBetween(startX, startY, endX, endY);
+  if (bridge < 0) { return -1; }
+  // There have to be isles at both positions and the end has to be the
+  // nearest isle in that direction, so there is no third isle in between
+  // and the bridge is horizontal or vertical.
+
+  if (_board.getCount(bridge) > 1) { return -1; }
+  // Return if we already got two bridges between the isles.
+
+  if (_board.getCount(bridge) == 0 && _board.crossesBridge(bridge)) {
+    return -1;
+  }
+  // Bridges must not cross each other.
+
+  Move move;
+  move.bridge = bridge;
+  move.checkpoint = _board.addBridge(bridge);
+  // Counts the values of both isles down and joins their components.
+  _hints.update(bridge, _board.getCount(bridge));
+  _journal.record(move);
+  // If the journal is full, the oldest move drops out of it.
+  return bridge;
+}
+
+// ____________________________________________________________________________
+int Game::undo() {
+  if (_journal.undoable() == 0) { return -1; }
+  // Nobody has start playing so we can't undo something.
+  const Move& move = _journal.undo();
+  _board.removeBridge(move.bridge, move.checkpoint);
+  // Counts the values up again and takes the union back.
+  _hints.update(move.bridge, _board.getCount(move.bridge));
+  return move.bridge;
+}
+
+// ____________________________________________________________________________
+int Game::redo() {
+  if (_journal.redoable() == 0) { return -1; }
+  const Move& move = _journal.redo();
+  // The components are back at move.checkpoint after the undo, so building
+  // the bridge again gives the same checkpoint.
+  _board.addBridge(move.bridge);
+  _hints.update(move.bridge, _board.getCount(move.bridge));
+  return move.bridge;
+}
+
+// ____________________________________________________________________________
+bool Game::loadSolution(const std::string& filename, std::string* error) {
+  // The whole file is read and checked by the board first.
+  if (!_board.loadSolution(filename, error)) { return false; }
+  _journal.clear();
+  _hints.reset(_board);
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Game::solved() const {
+  // All values are 0 and all isles are connected.
+  return _board.solved();
+}
+
+// ____________________________________________________________________________
+bool Game::save(const std::string& filename, std::string* error) const {
+  return writeSnapshot(filename, _puzzle, &_board, error);
+}
+
+// ____________________________________________________________________________
+int Game::bridgeBetween(size_t startX, size_t startY, size_t endX,
+                        size_t endY) const {
+  int start = _board.isleAt(startX, startY);
+  int end = _board.isleAt(endX, endY);
+  if (start < 0 || end < 0) { return -1; }
+  return _board.bridgeBetween(start, end);
+}
@@ -0,0 +1,78 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <stdio.h>
+#include <string>
+#include "./Board.h"
+#include "./HintEngine.h"
+#include "./Journal.h"
+#include "./Puzzle.h"
+
+// The rules of a game in progress, without ncurses: which bridges may be
+// built, undo and redo, loading and saving, and the hint engine which
+// follows every change. Hashi draws it and turns the input into calls of
+// it, the tools can play it without a terminal.
+class Game {
+ public:
+  // Constructor, an empty board.
+  Game();
+
+  // Starts over with the instance filename (a *.hashi snapshot brings its
+  // bridges along), which keeps the latest undos moves to undo (-1 for
+  // unlimited). Returns false and writes a message to error if the file
+  // can't be read.
+  bool load(const std::string& filename, int undos, std::string* error);
+
+  // Builds another bridge between the isles at grid positions (startX,
+  // startY) and (endX, endY), if there are isles, they are neighbours, the
+  // record has less than two bridges and a new bridge wouldn't cross
+  // another one. Returns the bridge record or -1 if nothing was built.
+  int build(size_t startX, size_t startY, size_t endX, size_t endY);
+
+  // Takes the latest bridge back (at most undos times in a row) or builds
+  // the latest undone bridge again. Returns the bridge record or -1 if
+  // there was nothing to do.
+  int undo();
+  int redo();
+
+  // Replaces all bridges by the ones of the solution file, nothing is built
+  // if a bridge of the file isn't possible. Returns false and writes a
+  // message to error in that case. Nothing can be undone afterwards.
+  bool loadSolution(const std::string& filename, std::string* error);
+
+  // Every isle has all its bridges and all isles are connected, O(1).
+  bool solved() const;
+
+  // Writes the isles and bridges as a snapshot to filename, loading that
+  // file resumes the game. Returns false and writes a message to error if
+  // the file can't be written.
+  bool save(const std::string& filename, std::string* error) const;
+
+  // Returns the bridge record between the isles at grid positions (startX,
+  // startY) and (endX, endY) or -1 if there are no such neighbours.
+  int bridgeBetween(size_t startX, size_t startY, size_t endX,
+                    size_t endY) const;
+
+  // The instance as it was read, the isles and bridges and the forced moves
+  // and dead ends of them.
+  const Puzzle& puzzle() const { return _puzzle; }
+  const Board& board() const { return _board; }
+  HintEngine& hints() { return _hints; }
+
+ private:
+  // A bridge we built, together with the state of the components before.
+  struct Move {
+    size_t bridge;
+    size_t checkpoint;
+  };
+
+  Puzzle _puzzle;
+  Board _board;
+  Journal<Move> _journal;
+  HintEngine _hints;
+};
+
+#endif  // GAME_H_
@@ -0,0 +1,59 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include "./Game.h"
+
+// ____________________________________________________________________________
+TEST(GameTest, buildUndoRedo) {
+  Game game;
+  std::string error;
+  ASSERT_FALSE(game.load("nonexistent.xy", 1, &error));
+  ASSERT_TRUE(game.load("i018-n005-s13x08.xy", 1, &error)) << error;
+  ASSERT_EQ(5u, game.board().numIsles());
+  int b = game.bridgeBetween(0, 0, 9, 0);
+  ASSERT_LE(0, b);
+  // No isle, the same isle, not in line and an isle in between.
+  ASSERT_EQ(-1, game.build(0, 0, 5, 0));
+  ASSERT_EQ(-1, game.build(0, 0, 0, 0));
+  ASSERT_EQ(-1, game.build(0, 0, 12, 7));
+  ASSERT_EQ(b, game.build(0, 0, 9, 0));
+  ASSERT_EQ(b, game.build(9, 0, 0, 0));
+  // At most two bridges.
+  ASSERT_EQ(-1, game.build(0, 0, 9, 0));
+  ASSERT_EQ(2, game.board().getCount(b));
+
+  // Only one undo.
+  ASSERT_EQ(b, game.undo());
+  ASSERT_EQ(-1, game.undo());
+  ASSERT_EQ(1, game.board().getCount(b));
+  ASSERT_EQ(b, game.redo());
+  ASSERT_EQ(-1, game.redo());
+  ASSERT_EQ(2, game.board().getCount(b));
+  ASSERT_FALSE(game.solved());
+}
+
+// ____________________________________________________________________________
+TEST(GameTest, solutionAndSave) {
+  Game game;
+  std::string error;
+  ASSERT_TRUE(game.load("i018-n005-s13x08.xy", -1, &error)) << error;
+  const char* solution = "/tmp/GameTest.solution";
+  FILE* file = fopen(solution, "w");
+  fputs("0,0,9,0\n0,0,9,0\n0,0,0,7\n9,0,9,3\n0,7,12,7\n", file);
+  fclose(file);
+  ASSERT_TRUE(game.loadSolution(solution, &error)) << error;
+  ASSERT_TRUE(game.solved());
+  ASSERT_EQ(-1, game.undo());
+  remove(solution);
+
+  const char* snapshot = "/tmp/GameTest.hashi";
+  ASSERT_TRUE(game.save(snapshot, &error)) << error;
+  Game resumed;
+  ASSERT_TRUE(resumed.load(snapshot, 5, &error)) << error;
+  ASSERT_TRUE(resumed.solved());
+  ASSERT_EQ(13u, resumed.puzzle().getWidth());
+  remove(snapshot);
+}
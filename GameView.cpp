@@ -0,0 +1,436 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./Game.h"
+#include "./GameView.h"
+#include "./HintEngine.h"
+#include "./Neighbours.h"
+#include "./Object.h"
+#include "./Session.h"
+#include "./Stats.h"
+
+// ____________________________________________________________________________
+GameView::GameView() : _board(_game.board()) {
+  _undos = 5;
+  _statusColor = 2;
+}
+
+// ____________________________________________________________________________
+bool GameView::load(const std::string& filename, int undos,
+                    std::string* error) {
+  if (!_game.load(filename, undos, error)) { return false; }
+  _inputFileName = filename;
+  _undos = undos;
+  // The clicks were on the old board.
+  _lastClickedX = -1;
+  _lastClickedY = -1;
+  _viewport.setBoard(_board.getWidth(), _board.getHeight());
+  return true;
+}
+
+// ____________________________________________________________________________
+void GameView::resize(size_t width, size_t height) {
+  _viewport.setScreen(width, height);
+  _canvas.reset(width, height);
+  drawBoard();
+}
+
+// ____________________________________________________________________________
+int GameView::bridgeBetween(std::pair<size_t, size_t> s,
+                         std::pair<size_t, size_t> e) const {
+  return _game.bridgeBetween(s.first, s.second, e.first, e.second);
+}
+
+// ____________________________________________________________________________
+void GameView::printAround(long y, long x, int color) {
+  for (int i = -1; i < 2; i++) {
+    for (int j = -1; j < 2; j++) {
+      _canvas.put(x+i, y+j, ' ', color, true);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void GameView::drawIsle(Isle isle) {
+  int color = 2;
+  // Basic case: Draw white on black.
+  if (isle.getValue() == 0) {
+    color = 1;
+    // Isle has value = 0: Draw green on black.
+  } else if (isle.getValue() < 0) {
+    color = 3;
+    // Isle has to many bridges: Draw red on black.
+  }
+  long x = _viewport.screenX(isle.getX());
+  long y = _viewport.screenY(isle.getY());
+  if (_viewport.isleRadius() > 0) {
+    printAround(y, x, color);
+    // Draw a 3x3 Isle.
+  }
+  _canvas.print(x, y, std::to_string(isle.getValue()), color, true);
+}
+
+// ____________________________________________________________________________
+void GameView::drawBoard() {
+  STAT_TIMER(STAT_DRAW_BOARD);
+  _canvas.clear();
+  // Only the isles on the screen and the bridges which reach into it. A
+  // bridge can also come from an isle left of or above the screen.
+  const Board& board = _board;
+  auto beforeX = [&board](uint32_t i, size_t x) { return board.getX(i) < x; };
+  auto beforeY = [&board](uint32_t i, size_t y) { return board.getY(i) < y; };
+  for (size_t y = _viewport.firstY(); y < _viewport.endY(); y++) {
+    const uint32_t* it = std::lower_bound(_board.rowBegin(y), _board.rowEnd(y),
+                                          _viewport.firstX(), beforeX);
+    if (it != _board.rowBegin(y) && _board.getBridge(*(it - 1), RIGHT) >= 0) {
+      drawBridge(_board.bridge(_board.getBridge(*(it - 1), RIGHT)));
+    }
+    for (; it != _board.rowEnd(y) && _board.getX(*it) < _viewport.endX();
+         it++) {
+      drawIsle(_board.isle(*it));
+      if (_board.getBridge(*it, RIGHT) >= 0) {
+        drawBridge(_board.bridge(_board.getBridge(*it, RIGHT)));
+      }
+    }
+  }
+  for (size_t x = _viewport.firstX(); x < _viewport.endX(); x++) {
+    const uint32_t* it = std::lower_bound(_board.columnBegin(x),
+                                          _board.columnEnd(x),
+                                          _viewport.firstY(), beforeY);
+    if (it != _board.columnBegin(x) &&
+        _board.getBridge(*(it - 1), DOWN) >= 0) {
+      drawBridge(_board.bridge(_board.getBridge(*(it - 1), DOWN)));
+    }
+    for (; it != _board.columnEnd(x) && _board.getY(*it) < _viewport.endY();
+         it++) {
+      if (_board.getBridge(*it, DOWN) >= 0) {
+        drawBridge(_board.bridge(_board.getBridge(*it, DOWN)));
+      }
+    }
+  }
+  drawStatus();
+}
+
+// ____________________________________________________________________________
+void GameView::showStatus(const std::string& text) { showStatus(text, 2); }
+
+// ____________________________________________________________________________
+void GameView::showStatus(const std::string& text, int color) {
+  if (text == _status && color == _statusColor) { return; }
+  // The old message may cover isles and bridges, so the board is drawn
+  // again. Only the cells which really changed reach the terminal.
+  _status = text;
+  _statusColor = color;
+  drawBoard();
+}
+
+// ____________________________________________________________________________
+void GameView::drawStatus() {
+  long x = 0;
+  long y = 0;
+  for (char ch : _status) {
+    if (ch == '\n') {
+      x = 0;
+      y++;
+      continue;
+    }
+    _canvas.put(x++, y, ch, _statusColor, false);
+  }
+}
+
+// ____________________________________________________________________________
+void GameView::handleEvent(const SessionEvent& event) {
+  STAT_TIMER(STAT_INPUT);
+  int key = event.key;
+  // A message only stays until the next input.
+  if (!_status.empty() && key != kKeyResize) { showStatus(""); }
+  switch (key) {
+    case 'u':
+      // undo a bridge when u is pressed.
+      undo();
+      break;
+    case 'r':
+      // redo the bridge we took back last.
+      redo();
+      break;
+    case 's': {
+      // If you press s you can give the programm a solution file and it shows
+      // the correct solution. The front end asked for its name.
+      // The board starts over when the instance is read again, so nothing
+      // of the old isles and bridges is left.
+      std::string error;
+      if (!load(_inputFileName, _undos, &error)) {
+        showStatus(error);
+        break;
+      }
+      resize(_canvas.getWidth(), _canvas.getHeight());
+      solve(event.text);
+      break;
+    }
+    case 'w': {
+      // Save the game, it goes on from here when it's started with the
+      // snapshot.
+      std::string error;
+      showStatus(save(&error) ? "Saved " + snapshotFileName() : error);
+      break;
+    }
+    case 'h': {
+      // Show what the hint engine found out so far, it works on its own
+      // thread and we never wait for it (except in a replay).
+      Hint hint;
+      std::string text = _game.hints().hint(&hint) ? hintText(hint, _board) :
+                                              "No hint yet, still thinking";
+      showStatus(text);
+      break;
+    }
+    case kKeyLeft:
+    case kKeyRight:
+    case kKeyUp:
+    case kKeyDown:
+      // Scroll the board with the arrow keys.
+      if (_viewport.pan(key == kKeyLeft ? -1 : key == kKeyRight ? 1 : 0,
+                        key == kKeyUp ? -1 : key == kKeyDown ? 1 : 0)) {
+        drawBoard();
+      }
+      break;
+    case '+':
+    case '-':
+      // Zoom in and out.
+      if (_viewport.zoom(key == '+' ? 1 : -1)) { drawBoard(); }
+      break;
+    case kKeyResize:
+      resize(event.x, event.y);
+      break;
+    case kKeyMouse:
+      // convert the mouse click.
+      if (event.buttons & kButton1Clicked) {
+        // Remember which isles were clicked, not where.
+        int isle = isIsle(event.x, event.y);
+        _startIsleX = _lastClickedX;
+        _startIsleY = _lastClickedY;
+        _lastClickedX = isle >= 0 ? _board.getX(isle) : -1;
+        _lastClickedY = isle >= 0 ? _board.getY(isle) : -1;
+        newBridge(_startIsleX, _startIsleY, _lastClickedX, _lastClickedY);
+      }
+      break;
+  }
+  // The 'Victory!!!' stays as long as the game is won, Hashi::play() lets
+  // it blink.
+  if (victory()) { showStatus("Victory!!!", _statusColor); }
+}
+
+// ____________________________________________________________________________
+bool GameView::replay(const Session& session, std::vector<uint64_t>* nanos,
+                      std::string* error) {
+  // The thread of the hint engine would take turns with the replay, and an
+  // h would show how far it got.
+  _game.hints().setBackground(false);
+  if (!load(session.inputFileName, session.undos, error)) { return false; }
+  resize(session.width, session.height);
+  auto discard = [](size_t, size_t, const Cell&) {};
+  _canvas.flush(discard);
+  nanos->assign(session.events.size(), 0);
+  for (size_t k = 0; k < session.events.size(); k++) {
+    int key = session.events[k].key;
+    // Escape ended the game. The w key wrote a file, that isn't part of
+    // the replay. The s key loads the solution file of the event again.
+    if (key == kKeyEscape) {
+      nanos->resize(k);
+      break;
+    }
+    if (key == 'w') { continue; }
+    // The cells Hashi::showState() would have written, without the
+    // terminal.
+    auto start = std::chrono::steady_clock::now();
+    handleEvent(session.events[k]);
+    _canvas.flush(discard);
+    (*nanos)[k] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void GameView::newBridge(int startX, int startY, int endX, int endY) {
+  STAT_TIMER(STAT_NEW_BRIDGE);
+  if (startX < 0 || startY < 0 || endX < 0 || endY < 0) { return; }
+  // Don't create a bridge if it is the first click or one of the last two
+  // clicks wasn't on an isle.
+
+  _start = std::pair<size_t, size_t>(startX, startY);
+  _end = std::pair<size_t, size_t>(endX, endY);
+  int bridge = _game.build(startX, startY, endX, endY);
+  if (bridge < 0) { return; }
+  // The game knows the rules, see Game::build().
+
+  _lastClickedX = -1;
+  _lastClickedY = -1;
+  // All done? So reset your latest clicks.
+
+  drawBridge(_board.bridge(bridge));
+  drawIsle(_board.isle(_board.getStart(bridge)));
+  drawIsle(_board.isle(_board.getEnd(bridge)));
+  // Draw the new state of this bridge and its isles, nothing else changed.
+}
+
+// ____________________________________________________________________________
+void GameView::drawBridge() {
+  for (size_t b = 0; b < _board.numBridges(); b++) {
+    // Draw every bridge new, only the cells which change get flushed.
+    if (_board.getCount(b) > 0) { drawBridge(_board.bridge(b)); }
+  }
+}
+
+// ____________________________________________________________________________
+void GameView::drawBridge(Bridge bridge) {
+  STAT_TIMER(STAT_DRAW_BRIDGE);
+  std::pair<size_t, size_t> start = bridge.getStart();
+  std::pair<size_t, size_t> end = bridge.getEnd();
+  int flag = bridge.getCount() - 1;
+  if (flag > 1) { return; }
+  // Normally this should never happen, because we check it already
+  // in the newBridge()-function.
+
+  // The records always go from left to right or from top to bottom. The
+  // cells next to the isles are covered by them, everything outside of the
+  // canvas gets skipped.
+  long r = _viewport.isleRadius();
+  if (start.first == end.first) {
+    // If we want to draw a vertical bridge.
+    long x = _viewport.screenX(start.first);
+    if (x < 0 || x >= static_cast<long>(_canvas.getWidth())) { return; }
+    long first = std::max(_viewport.screenY(start.second) + r + 1, 0L);
+    long last = std::min(_viewport.screenY(end.second) - r - 1,
+                         static_cast<long>(_canvas.getHeight()) - 1);
+    for (long i = first; i <= last; i++) {
+      if (flag == 1) {
+        // Already exists one bridge.
+        _canvas.put(x, i, 'H', 2, false);
+      } else if (flag == 0) {
+        // The first bridge between the isles.
+        _canvas.put(x, i, '|', 2, false);
+      } else if (_canvas.get(x, i).ch != '-' && _canvas.get(x, i).ch != '=') {
+        // No bridge anymore, but don't erase one crossing it.
+        _canvas.put(x, i, ' ', 0, false);
+      }
+    }
+  } else if (start.second == end.second) {
+    // If we want to draw a horizontal bridge.
+    long y = _viewport.screenY(start.second);
+    if (y < 0 || y >= static_cast<long>(_canvas.getHeight())) { return; }
+    long first = std::max(_viewport.screenX(start.first) + r + 1, 0L);
+    long last = std::min(_viewport.screenX(end.first) - r - 1,
+                         static_cast<long>(_canvas.getWidth()) - 1);
+    for (long i = first; i <= last; i++) {
+      if (flag == 1) {
+        _canvas.put(i, y, '=', 2, false);
+      } else if (flag == 0) {
+        _canvas.put(i, y, '-', 2, false);
+      } else if (_canvas.get(i, y).ch != '|' && _canvas.get(i, y).ch != 'H') {
+        _canvas.put(i, y, ' ', 0, false);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+int GameView::checkBridge(std::pair<size_t, size_t> s,
+                       std::pair<size_t, size_t> e) {
+  // Every isle pair has exactly one record, so we only have to look it up.
+  int bridge = bridgeBetween(s, e);
+  if (bridge < 0) { return 0; }
+  return _board.getCount(bridge);
+}
+
+// ____________________________________________________________________________
+bool GameView::blocked(std::pair<size_t, size_t> start,
+                    std::pair<size_t, size_t> end) {
+  STAT_TIMER(STAT_BLOCKED);
+  // Both are binary searches in the sorted isles of the row or column and
+  // in the cells covered by bridges.
+  return _board.isleBetween(start.first, start.second, end.first,
+                            end.second) ||
+         _board.crossesBridge(start.first, start.second, end.first,
+                              end.second);
+}
+
+// ____________________________________________________________________________
+int GameView::isleAt(size_t x, size_t y) const { return _board.isleAt(x, y); }
+
+// ____________________________________________________________________________
+int GameView::isIsle(size_t x, size_t y) {
+  STAT_TIMER(STAT_IS_ISLE);
+  // The viewport knows which grid position is drawn under the click.
+  size_t gridX;
+  size_t gridY;
+  if (!_viewport.toGrid(x, y, &gridX, &gridY)) { return -1; }
+  return isleAt(gridX, gridY);
+}
+
+// ____________________________________________________________________________
+void GameView::undo() {
+  STAT_TIMER(STAT_UNDO);
+  int bridge = _game.undo();
+  if (bridge < 0) { return; }
+  // undo the latest built bridge.
+  drawBridge(_board.bridge(bridge));
+  drawIsle(_board.isle(_board.getStart(bridge)));
+  drawIsle(_board.isle(_board.getEnd(bridge)));
+  // Redraw the single or erased bridge and both isles.
+}
+
+// ____________________________________________________________________________
+void GameView::redo() {
+  STAT_TIMER(STAT_REDO);
+  int bridge = _game.redo();
+  if (bridge < 0) { return; }
+  drawBridge(_board.bridge(bridge));
+  drawIsle(_board.isle(_board.getStart(bridge)));
+  drawIsle(_board.isle(_board.getEnd(bridge)));
+}
+
+// ____________________________________________________________________________
+int GameView::victory() {
+  STAT_TIMER(STAT_VICTORY);
+  // All values are 0 and all isles are connected, you won.
+  return _game.solved();
+}
+
+// ____________________________________________________________________________
+void GameView::solve(const std::string& filename) {
+  // The whole file is read and checked by the board first, then all
+  // bridges are drawn at once.
+  std::string error;
+  if (!_game.loadSolution(filename, &error)) {
+    showStatus(error);
+    return;
+  }
+  drawBoard();
+  if (victory() == 0) {
+    // In case something didn't work out with the solution file.
+    showStatus(filename + " is the wrong solution file,\n"
+               "or at least one bridge is built the wrong way.");
+  }
+}
+
+// ____________________________________________________________________________
+bool GameView::save(std::string* error) {
+  return _game.save(snapshotFileName(), error);
+}
+
+// ____________________________________________________________________________
+std::string GameView::snapshotFileName() const {
+  const std::string ending = ".hashi";
+  if (_inputFileName.size() >= ending.size() &&
+      _inputFileName.compare(_inputFileName.size() - ending.size(),
+                             ending.size(), ending) == 0) {
+    return _inputFileName;
+  }
+  return _inputFileName + ending;
+}
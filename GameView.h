@@ -0,0 +1,166 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef GAMEVIEW_H_
+#define GAMEVIEW_H_
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./Board.h"
+#include "./Canvas.h"
+#include "./Game.h"
+#include "./Object.h"
+#include "./Session.h"
+#include "./Viewport.h"
+
+// A game as it is shown on the screen, without ncurses: draws the isles,
+// bridges and messages into a canvas and turns the inputs into moves of the
+// game. Hashi writes the canvas to the terminal and reads the inputs from
+// it, HashiReplayMain plays recorded inputs without a terminal.
+class GameView {
+ public:
+  // Constructor, an empty board on an empty screen.
+  GameView();
+
+  // Starts over with the instance filename and undos, see Game::load().
+  // Returns false and writes a message to error if the file can't be read.
+  bool load(const std::string& filename, int undos, std::string* error);
+
+  // Prints around (x, y) to create a 3x3 isle.
+  void printAround(long y, long x, int color);
+
+  // Draws an isle with its value into the canvas.
+  void drawIsle(Isle isle);
+
+  // Draws the isles and bridges on the screen into the canvas, and the
+  // status message on top of them.
+  void drawBoard();
+
+  // Shows text (one or more lines) in the top left corner of the canvas
+  // until the next input, an empty text takes the message away.
+  void showStatus(const std::string& text);
+
+  // The same in the colour pair color, for the blinking 'Victory!!!'.
+  void showStatus(const std::string& text, int color);
+
+  // Draws the lines of _status into the canvas.
+  void drawStatus();
+
+  // Sets the size of the screen and draws the board again.
+  void resize(size_t width, size_t height);
+
+  // The action of one input. Escape, p and everything else which needs the
+  // terminal are left to the caller.
+  void handleEvent(const SessionEvent& event);
+
+  // Plays the events of session on the instance, undos and screen size of
+  // the recording, as fast as possible. Writes how long each event took in
+  // ns to nanos (0 for the skipped w keys), it ends early at an Escape. The
+  // hint engine works without its thread from now on, so an h shows the
+  // same hint in every replay. Returns false and writes a message to error
+  // if the instance can't be read.
+  bool replay(const Session& session, std::vector<uint64_t>* nanos,
+              std::string* error);
+
+  // Creates a bridge between the isles at grid positions (startX, startY)
+  // and (endX, endY). Negative positions mean there was no isle clicked.
+  void newBridge(int startX, int startY, int endX, int endY);
+
+  // Returns true if a Isle is in the middle of to other isles you
+  // wanted to connect with a bridge or if a bridge would cross another one.
+  bool blocked(std::pair<size_t, size_t> start, std::pair<size_t, size_t> end);
+
+  // Returns the isle drawn at the clicked screen position or -1.
+  int isIsle(size_t x, size_t y);
+
+  // Draws all bridges into the canvas.
+  void drawBridge();
+
+  // Check whether we can build another bridge on that isle or not.
+  // Returns the amount of bridges between to isles.
+  int checkBridge(std::pair<size_t, size_t> s, std::pair<size_t, size_t> e);
+
+  // Undos a bridge (max. _undos times)
+  void undo();
+
+  // Builds the latest undone bridge again.
+  void redo();
+
+  // Checks whether the Hashi is solved: every isle has all its bridges and
+  // all isles are connected. Both are kept up to date by newBridge() and
+  // undo(), so this takes O(1).
+  int victory();
+
+  // Builds all bridges of the solution file filename at once. Nothing is
+  // built if a bridge of the file isn't possible.
+  void solve(const std::string& filename);
+
+  // Saves the isles and bridges to snapshotFileName(), starting the game
+  // with that file resumes it. Returns false and writes a message to error
+  // if the file can't be written.
+  bool save(std::string* error);
+
+  // The input file if it's a *.hashi snapshot, otherwise <inputfile>.hashi.
+  std::string snapshotFileName() const;
+
+  // The game, what is shown of it and the message on top.
+  Game& game() { return _game; }
+  const Board& board() const { return _board; }
+  Viewport& viewport() { return _viewport; }
+  Canvas& canvas() { return _canvas; }
+  const std::string& status() const { return _status; }
+  int undos() const { return _undos; }
+
+ private:
+  // Returns the bridge record between s and e or -1 if they aren't
+  // neighbours.
+  int bridgeBetween(std::pair<size_t, size_t> s,
+                    std::pair<size_t, size_t> e) const;
+
+  // Draws one bridge record with its current count (erases it if there
+  // is no bridge anymore).
+  void drawBridge(Bridge bridge);
+
+  // Returns the isle at exactly (x, y) or -1.
+  int isleAt(size_t x, size_t y) const;
+
+  // That's how often we can undo something (-1 for unlimited).
+  int _undos;
+
+  // The File Name.
+  std::string _inputFileName;
+
+  // Grid position of the isle of the latest click (-1 if there was none).
+  int _lastClickedX = -1;
+  int _lastClickedY = -1;
+
+  // Grid position of the isle of the second latest click.
+  int _startIsleX = -1;
+  int _startIsleY = -1;
+
+  // Start and end coordinates of a bridge.
+  std::pair<size_t, size_t> _start;
+  std::pair<size_t, size_t> _end;
+
+  // The isles, the bridges, the moves we can undo and redo and the hints,
+  // everything but the drawing.
+  Game _game;
+
+  // The isles and bridges of _game, to draw them.
+  const Board& _board;
+
+  // Which part of the board is shown and how big.
+  Viewport _viewport;
+
+  // Offscreen copy of the screen, Hashi writes the cells which changed to
+  // the terminal.
+  Canvas _canvas;
+
+  // The message of the last input, see showStatus().
+  std::string _status;
+  int _statusColor;
+};
+
+#endif  // GAMEVIEW_H_
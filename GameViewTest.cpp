@@ -0,0 +1,361 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./GameView.h"
+#include "./HintEngine.h"
+#include "./Session.h"
+
+// ____________________________________________________________________________
+TEST(GameViewTest, isleIndex) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  // The isle (9, 0) is drawn at (50, 5), every click in its 3x3 block hits.
+  ASSERT_EQ(view.board().isleAt(9, 0), view.isIsle(51, 6));
+  ASSERT_EQ(view.board().isleAt(9, 0), view.isIsle(49, 4));
+  ASSERT_EQ(-1, view.isIsle(52, 5));
+  ASSERT_LE(0, view.board().isleAt(9, 0));
+  ASSERT_EQ(-1, view.board().isleAt(9, 1));
+  Isle isle = view.board().isle(view.board().isleAt(9, 0));
+  ASSERT_EQ(9u, isle.getX());
+  ASSERT_EQ(3, isle.getValue());
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, blocked) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  typedef std::pair<size_t, size_t> P;
+  ASSERT_FALSE(view.blocked(P(0, 0), P(9, 0)));
+  ASSERT_FALSE(view.blocked(P(9, 3), P(9, 0)));
+  // (9, 3) is in between (9, 0) and (9, 7).
+  ASSERT_TRUE(view.blocked(P(9, 0), P(9, 7)));
+  ASSERT_TRUE(view.blocked(P(9, 7), P(9, 0)));
+  // Also right next to the end.
+  ASSERT_TRUE(view.blocked(P(9, 4), P(9, 2)));
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, neighbours) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  Isle topLeft = view.board().isle(view.board().isleAt(0, 0));
+  Isle right = view.board().isle(view.board().isleAt(9, 0));
+  ASSERT_EQ(view.board().isleAt(9, 0), topLeft.getNeighbour(RIGHT));
+  ASSERT_EQ(view.board().isleAt(0, 7), topLeft.getNeighbour(DOWN));
+  ASSERT_EQ(-1, topLeft.getNeighbour(UP));
+  ASSERT_EQ(-1, topLeft.getNeighbour(LEFT));
+  // (9, 0) only sees (9, 3) below, not (9, 7).
+  ASSERT_EQ(view.board().isleAt(9, 3), right.getNeighbour(DOWN));
+  ASSERT_EQ(view.board().isleAt(0, 0), right.getNeighbour(LEFT));
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, bridgeCount) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  typedef std::pair<size_t, size_t> P;
+  // One record per neighbouring pair: (0,0)-(9,0), (0,0)-(0,7),
+  // (9,0)-(9,3) and (0,7)-(12,7).
+  ASSERT_EQ(4u, view.board().numBridges());
+  view.newBridge(0, 0, 9, 0);
+  ASSERT_EQ(1, view.checkBridge(P(0, 0), P(9, 0)));
+  view.newBridge(9, 0, 0, 0);
+  ASSERT_EQ(2, view.checkBridge(P(9, 0), P(0, 0)));
+  // A third bridge is not allowed.
+  view.newBridge(0, 0, 9, 0);
+  ASSERT_EQ(2, view.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(1, view.board().getRemaining(view.board().isleAt(9, 0)));
+  // No bridge over (9, 3).
+  view.newBridge(9, 0, 9, 7);
+  ASSERT_EQ(0, view.checkBridge(P(9, 0), P(9, 7)));
+  view.undo();
+  ASSERT_EQ(1, view.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(2, view.board().getRemaining(view.board().isleAt(9, 0)));
+  view.undo();
+  ASSERT_EQ(0, view.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(3, view.board().getRemaining(view.board().isleAt(0, 0)));
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, undoRedo) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 2, &error)) << error;
+  typedef std::pair<size_t, size_t> P;
+  view.newBridge(0, 0, 9, 0);
+  view.newBridge(0, 0, 0, 7);
+  view.newBridge(9, 0, 9, 3);
+  // Only the latest two bridges can be undone.
+  view.undo();
+  view.undo();
+  view.undo();
+  ASSERT_EQ(1, view.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(0, view.checkBridge(P(0, 0), P(0, 7)));
+  ASSERT_EQ(4u, view.board().components());
+  view.redo();
+  ASSERT_EQ(1, view.checkBridge(P(0, 0), P(0, 7)));
+  ASSERT_EQ(3u, view.board().components());
+  // A new bridge drops the redo of (9, 0) - (9, 3).
+  view.newBridge(0, 7, 12, 7);
+  view.redo();
+  ASSERT_EQ(0, view.checkBridge(P(9, 0), P(9, 3)));
+  ASSERT_EQ(2u, view.board().components());
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, victory) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  ASSERT_EQ(0, view.victory());
+  view.newBridge(0, 0, 9, 0);
+  view.newBridge(0, 0, 9, 0);
+  view.newBridge(0, 0, 0, 7);
+  view.newBridge(9, 0, 9, 3);
+  ASSERT_EQ(0, view.victory());
+  view.newBridge(0, 7, 12, 7);
+  ASSERT_EQ(1, view.victory());
+  view.undo();
+  ASSERT_EQ(0, view.victory());
+  ASSERT_EQ(2u, view.board().components());
+  view.undo();
+  ASSERT_EQ(3u, view.board().components());
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, victoryNeedsConnection) {
+  // Two pairs of 1s: all values can be 0 without connecting the pairs.
+  FILE* file = fopen("/tmp/GameViewTest-pairs.xy", "w");
+  fprintf(file, "# 3:3 (xy)\n0,0,1\n2,0,1\n0,2,1\n2,2,1\n");
+  fclose(file);
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("/tmp/GameViewTest-pairs.xy", 5, &error)) << error;
+  view.newBridge(0, 0, 2, 0);
+  view.newBridge(0, 2, 2, 2);
+  ASSERT_EQ(0u, view.board().unsatisfied());
+  ASSERT_EQ(0, view.victory());
+  remove("/tmp/GameViewTest-pairs.xy");
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, noCrossing) {
+  // A plus: only one of the two bridges can be built.
+  FILE* file = fopen("/tmp/GameViewTest-plus.xy", "w");
+  fprintf(file, "# 3:3 (xy)\n1,0,1\n0,1,1\n2,1,1\n1,2,1\n");
+  fclose(file);
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("/tmp/GameViewTest-plus.xy", 5, &error)) << error;
+  typedef std::pair<size_t, size_t> P;
+  ASSERT_FALSE(view.blocked(P(0, 1), P(2, 1)));
+  view.newBridge(1, 0, 1, 2);
+  ASSERT_TRUE(view.blocked(P(0, 1), P(2, 1)));
+  view.newBridge(0, 1, 2, 1);
+  ASSERT_EQ(0, view.checkBridge(P(0, 1), P(2, 1)));
+  view.undo();
+  view.newBridge(0, 1, 2, 1);
+  ASSERT_EQ(1, view.checkBridge(P(0, 1), P(2, 1)));
+  remove("/tmp/GameViewTest-plus.xy");
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, render) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  view.resize(view.viewport().fullWidth(), view.viewport().fullHeight());
+  ASSERT_EQ(67u, view.canvas().getWidth());
+  std::string row = view.canvas().snapshot().substr(5 * 68, 67);
+  ASSERT_EQ(" 3 ", row.substr(4, 3));
+  view.canvas().flush([](size_t, size_t, const Cell&) {});
+  view.newBridge(0, 0, 9, 0);
+  // Only the 42 cells between the isles and both values changed.
+  ASSERT_EQ(44u, view.canvas().dirtyCells());
+  row = view.canvas().snapshot().substr(5 * 68, 67);
+  ASSERT_EQ(" 2 " + std::string(42, '-') + " 2 ", row.substr(4, 48));
+  view.newBridge(0, 0, 9, 0);
+  row = view.canvas().snapshot().substr(5 * 68, 67);
+  ASSERT_EQ(std::string(42, '='), row.substr(7, 42));
+  view.undo();
+  view.undo();
+  row = view.canvas().snapshot().substr(5 * 68, 67);
+  ASSERT_EQ(" 3 " + std::string(42, ' ') + " 3 ", row.substr(4, 48));
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, viewportCulling) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  view.newBridge(0, 7, 12, 7);
+  // A 20x12 screen shows the grid positions (0..3, 0..1).
+  view.resize(20, 12);
+  std::string screen = view.canvas().snapshot();
+  ASSERT_EQ(" 3 ", screen.substr(5 * 21 + 4, 3));
+  ASSERT_EQ(std::string::npos, screen.find('-'));
+  // Scroll to (1, 7): the bridge comes in from (0, 7) on the left and goes
+  // on to (12, 7) far right of the screen.
+  ASSERT_TRUE(view.viewport().pan(1, 7));
+  view.drawBoard();
+  screen = view.canvas().snapshot();
+  ASSERT_EQ("1 " + std::string(18, '-'), screen.substr(5 * 21, 20));
+  // Zoomed out every grid position is two cells away and isles are single
+  // cells.
+  ASSERT_TRUE(view.viewport().pan(-1, -7));
+  ASSERT_TRUE(view.viewport().zoom(-3));
+  view.resize(30, 20);
+  screen = view.canvas().snapshot();
+  ASSERT_EQ('3', screen[2 * 31 + 2]);
+  ASSERT_EQ('3', screen[2 * 31 + 20]);
+  ASSERT_EQ("1-----", screen.substr(16 * 31 + 2, 6));
+  ASSERT_EQ(view.board().isleAt(0, 0), view.isIsle(2, 2));
+  ASSERT_EQ(-1, view.isIsle(3, 2));
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, saveAndResume) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  ASSERT_EQ("i018-n005-s13x08.xy.hashi", view.snapshotFileName());
+  // The same instance in /tmp, where the snapshot goes.
+  ASSERT_TRUE(view.game().puzzle().write("/tmp/GameViewTest.xy", false,
+                                         &error)) << error;
+  ASSERT_TRUE(view.load("/tmp/GameViewTest.xy", 5, &error)) << error;
+  remove("/tmp/GameViewTest.xy");
+  view.newBridge(0, 0, 9, 0);
+  view.newBridge(0, 0, 9, 0);
+  view.newBridge(0, 7, 12, 7);
+  ASSERT_EQ("/tmp/GameViewTest.xy.hashi", view.snapshotFileName());
+  ASSERT_TRUE(view.save(&error)) << error;
+
+  GameView resumed;
+  ASSERT_TRUE(resumed.load("/tmp/GameViewTest.xy.hashi", 5, &error))
+      << error;
+  ASSERT_EQ("/tmp/GameViewTest.xy.hashi", resumed.snapshotFileName());
+  remove("/tmp/GameViewTest.xy.hashi");
+  typedef std::pair<size_t, size_t> P;
+  ASSERT_EQ(5u, resumed.board().numIsles());
+  ASSERT_EQ(2, resumed.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(1, resumed.checkBridge(P(0, 7), P(12, 7)));
+  ASSERT_EQ(0, resumed.checkBridge(P(9, 0), P(9, 3)));
+  ASSERT_EQ(1, resumed.board().getRemaining(resumed.board().isleAt(0, 0)));
+  ASSERT_EQ(3u, resumed.board().components());
+  ASSERT_EQ(13u, resumed.game().puzzle().getWidth());
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, hints) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  view.game().hints().wait();
+  Hint hint;
+  ASSERT_TRUE(view.game().hints().hint(&hint));
+  ASSERT_EQ(Hint::FORCED, hint.kind);
+  // The engine follows the bridges of the game and their undo.
+  view.newBridge(0, 0, 0, 7);
+  view.newBridge(0, 0, 0, 7);
+  view.game().hints().wait();
+  ASSERT_TRUE(view.game().hints().hint(&hint));
+  ASSERT_EQ(Hint::NO_ROOM, hint.kind);
+  view.undo();
+  view.game().hints().wait();
+  ASSERT_TRUE(view.game().hints().hint(&hint));
+  ASSERT_EQ(Hint::FORCED, hint.kind);
+}
+
+// ____________________________________________________________________________
+TEST(GameViewTest, statusLine) {
+  GameView view;
+  std::string error;
+  ASSERT_TRUE(view.load("i018-n005-s13x08.xy", 5, &error)) << error;
+  view.resize(view.viewport().fullWidth(), view.viewport().fullHeight());
+  view.game().hints().wait();
+  // Messages go through the canvas like the board, row 0 and on.
+  view.handleEvent(SessionEvent{0, 'h', false, 0, 0, 0});
+  ASSERT_NE("", view.status());
+  std::string screen = view.canvas().snapshot();
+  ASSERT_EQ(view.status().substr(0, 20), screen.substr(0, 20));
+  const char* filename = "/tmp/GameViewTest.solution";
+  FILE* file = fopen(filename, "w");
+  ASSERT_TRUE(file != NULL);
+  fprintf(file, "0,0,9,0\n");
+  fclose(file);
+  view.solve(filename);
+  screen = view.canvas().snapshot();
+  std::string first = std::string(filename) + " is the wrong solution file,";
+  ASSERT_EQ(first, screen.substr(0, first.size()));
+  ASSERT_EQ("or at least one", screen.substr(68, 15));
+  // The next input takes the message away, without a trace of it.
+  view.handleEvent(SessionEvent{0, 'h', false, 0, 0, 0});
+  screen = view.canvas().snapshot();
+  ASSERT_EQ(std::string(67, ' '), screen.substr(68, 67));
+  view.handleEvent(SessionEvent{0, 'u', false, 0, 0, 0});
+  screen = view.canvas().snapshot();
+  ASSERT_EQ("", view.status());
+  ASSERT_EQ(std::string(67, ' '), screen.substr(0, 67));
+  // A loaded solution can't be undone, the board stays as it was.
+  ASSERT_EQ(" 2 ", screen.substr(5 * 68 + 4, 3));
+
+  // The whole solution wins, the 'Victory!!!' is drawn like any message
+  // and stays after the next input.
+  file = fopen(filename, "w");
+  ASSERT_TRUE(file != NULL);
+  fprintf(file, "0,0,9,0\n0,0,9,0\n0,0,0,7\n9,0,9,3\n0,7,12,7\n");
+  fclose(file);
+  view.handleEvent(SessionEvent{0, 's', false, 0, 0, 0, filename});
+  screen = view.canvas().snapshot();
+  ASSERT_EQ("Victory!!!", screen.substr(0, 10));
+  ASSERT_EQ(std::string(67, ' '), screen.substr(68, 67));
+  view.handleEvent(SessionEvent{0, '+', false, 0, 0, 0});
+  ASSERT_EQ("Victory!!!", view.canvas().snapshot().substr(0, 10));
+  view.showStatus("Victory!!!", 1);
+  ASSERT_EQ(1, view.canvas().get(0, 0).color);
+  remove(filename);
+}
+
+
+// ____________________________________________________________________________
+TEST(GameViewTest, replay) {
+  // Two clicks build a bridge from (0, 0) to (9, 0), then the hint, which
+  // is the same in every replay.
+  Session session = {"i018-n005-s13x08.xy", -1, 80, 48, {}};
+  session.events.push_back(SessionEvent{0, kKeyMouse, true, 5, 5,
+                                        kButton1Clicked});
+  session.events.push_back(SessionEvent{0, kKeyMouse, true, 50, 5,
+                                        kButton1Clicked});
+  session.events.push_back(SessionEvent{0, 'h', false, 0, 0, 0});
+  session.events.push_back(SessionEvent{0, 'w', false, 0, 0, 0});
+  session.events.push_back(SessionEvent{0, kKeyEscape, false, 0, 0, 0});
+  session.events.push_back(SessionEvent{0, 'u', false, 0, 0, 0});
+  typedef std::pair<size_t, size_t> P;
+  for (int round = 0; round < 3; round++) {
+    GameView view;
+    std::vector<uint64_t> nanos;
+    std::string error;
+    ASSERT_TRUE(view.replay(session, &nanos, &error)) << error;
+    // Nothing after the Escape, the w key isn't played.
+    ASSERT_EQ(4u, nanos.size());
+    ASSERT_EQ(0u, nanos[3]);
+    ASSERT_EQ(1, view.checkBridge(P(0, 0), P(9, 0)));
+    ASSERT_EQ(-1, view.undos());
+    ASSERT_EQ("Hint: isle 0,0 needs another bridge to 0,7", view.status());
+  }
+  session.inputFileName = "/tmp/GameViewTest-missing.xy";
+  GameView view;
+  std::vector<uint64_t> nanos;
+  std::string error;
+  ASSERT_FALSE(view.replay(session, &nanos, &error));
+  ASSERT_NE("", error);
+}
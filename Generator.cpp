@@ -0,0 +1,200 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "./Generator.h"
+#include "./Solver.h"
+
+// The directions as (dx, dy).
+static const int kSteps[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+
+// ____________________________________________________________________________
+Generator::Generator(size_t width, size_t height, double density)
+    : _width(width), _height(height) {
+  density = std::min(std::max(density, 0.0), 0.2);
+  _targetIsles = std::max<size_t>(2, density * width * height);
+  // Isles which are about 1 / sqrt(density) apart on average.
+  _maxLength = std::max<size_t>(2, 2 / sqrt(std::max(density, 0.01)));
+}
+
+// ____________________________________________________________________________
+bool Generator::generate(uint64_t seed, Puzzle* puzzle) {
+  if (_width * _height < 3) { return false; }
+  _random.seed(seed);
+  for (int attempt = 0; attempt < 10; attempt++) {
+    reset();
+    grow();
+    if (_x.size() < 2) { continue; }
+    if (makeUnique()) {
+      buildPuzzle(puzzle);
+      return true;
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+void Generator::reset() {
+  _cells.assign(_width * _height, -1);
+  _covered.assign(_width * _height, 0);
+  _x.clear();
+  _y.clear();
+  _value.clear();
+  _bridges.clear();
+  _bridges.reserve(2 * _targetIsles);
+  size_t cell = _random() % (_width * _height);
+  _x.push_back(cell % _width);
+  _y.push_back(cell / _width);
+  _value.push_back(0);
+  _cells[cell] = 0;
+}
+
+// ____________________________________________________________________________
+void Generator::grow() {
+  // Isles which may still get a new neighbour. One which failed a few times
+  // is most likely surrounded and is dropped.
+  std::vector<size_t> open(1, 0);
+  while (_x.size() < _targetIsles && !open.empty()) {
+    size_t k = _random() % open.size();
+    bool grown = false;
+    for (int attempt = 0; attempt < 8 && !grown; attempt++) {
+      grown = growFrom(open[k]);
+    }
+    if (grown) {
+      open.push_back(_x.size() - 1);
+    } else {
+      open[k] = open.back();
+      open.pop_back();
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool Generator::growFrom(size_t i) {
+  const int* step = kSteps[_random() % 4];
+  size_t length = 2 + _random() % (_maxLength - 1);
+  long x = _x[i] + step[0] * static_cast<long>(length);
+  long y = _y[i] + step[1] * static_cast<long>(length);
+  if (x < 0 || y < 0 || x >= static_cast<long>(_width) ||
+      y >= static_cast<long>(_height)) {
+    return false;
+  }
+  size_t cell = y * _width + x;
+  if (_cells[cell] >= 0 || _covered[cell]) { return false; }
+  // No isle right next to the new one, there would be no room for a bridge.
+  for (const int* next : kSteps) {
+    long nx = x + next[0];
+    long ny = y + next[1];
+    if (nx >= 0 && ny >= 0 && nx < static_cast<long>(_width) &&
+        ny < static_cast<long>(_height) && _cells[ny * _width + nx] >= 0) {
+      return false;
+    }
+  }
+  size_t j = _x.size();
+  _x.push_back(x);
+  _y.push_back(y);
+  _value.push_back(0);
+  if (!pathFree(i, j)) {
+    _x.pop_back();
+    _y.pop_back();
+    _value.pop_back();
+    return false;
+  }
+  _cells[cell] = j;
+  addBridge(i, j, 1 + _random() % 2);
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Generator::pathFree(size_t a, size_t b) const {
+  if (_x[a] == _x[b]) {
+    size_t top = std::min(_y[a], _y[b]);
+    size_t bottom = std::max(_y[a], _y[b]);
+    for (size_t y = top + 1; y < bottom; y++) {
+      size_t cell = y * _width + _x[a];
+      if (_cells[cell] >= 0 || _covered[cell]) { return false; }
+    }
+  } else {
+    size_t left = std::min(_x[a], _x[b]);
+    size_t right = std::max(_x[a], _x[b]);
+    for (size_t x = left + 1; x < right; x++) {
+      size_t cell = _y[a] * _width + x;
+      if (_cells[cell] >= 0 || _covered[cell]) { return false; }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void Generator::addBridge(size_t a, size_t b, int count) {
+  _bridges[pairKey(a, b)] += count;
+  _value[a] += count;
+  _value[b] += count;
+  for (size_t x = std::min(_x[a], _x[b]) + 1; x < std::max(_x[a], _x[b]);
+       x++) {
+    _covered[_y[a] * _width + x] = 1;
+  }
+  for (size_t y = std::min(_y[a], _y[b]) + 1; y < std::max(_y[a], _y[b]);
+       y++) {
+    _covered[y * _width + _x[a]] = 1;
+  }
+}
+
+// ____________________________________________________________________________
+bool Generator::makeUnique() {
+  _order.resize(_x.size());
+  for (size_t i = 0; i < _order.size(); i++) { _order[i] = i; }
+  std::sort(_order.begin(), _order.end(), [this](size_t a, size_t b) {
+    return _x[a] != _x[b] ? _x[a] < _x[b] : _y[a] < _y[b];
+  });
+  // The edges only depend on the positions of the isles, so one solver does
+  // for all rounds, only the values change.
+  Puzzle puzzle;
+  buildPuzzle(&puzzle);
+  Solver solver(puzzle);
+  for (int round = 0; round < 50; round++) {
+    for (size_t k = 0; k < _order.size(); k++) {
+      puzzle.setValue(k, _value[_order[k]]);
+    }
+    // The bridges are a solution, so there is no contradiction.
+    if (!solver.deduce()) { return false; }
+    bool decided = true;
+    for (size_t e = 0; e < solver.numEdges(); e++) {
+      if (solver.isDecided(e)) { continue; }
+      decided = false;
+      // Most edges are changed, but not all: a change usually decides some
+      // of the edges around it as well.
+      if (_random() % 4 == 0) { continue; }
+      size_t a = _order[solver.getStart(e)];
+      size_t b = _order[solver.getEnd(e)];
+      auto bridge = _bridges.find(pairKey(a, b));
+      if (bridge != _bridges.end()) {
+        // A single bridge becomes a double one and the other way round.
+        int delta = bridge->second == 1 ? 1 : -1;
+        bridge->second += delta;
+        _value[a] += delta;
+        _value[b] += delta;
+      } else if (pathFree(a, b)) {
+        addBridge(a, b, 1);
+      }
+    }
+    if (decided) { return true; }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+void Generator::buildPuzzle(Puzzle* puzzle) const {
+  *puzzle = Puzzle();
+  for (size_t i : _order) { puzzle->addIsle(_x[i], _y[i], _value[i]); }
+  puzzle->setSize(_width, _height);
+}
+
+// ____________________________________________________________________________
+uint64_t Generator::pairKey(size_t a, size_t b) {
+  if (a > b) { std::swap(a, b); }
+  return static_cast<uint64_t>(a) << 32 | b;
+}
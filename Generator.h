@@ -0,0 +1,83 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "./Puzzle.h"
+
+// Generates random puzzles with exactly one solution. The isles grow like a
+// tree: every new isle is put on a free cell in sight of an isle which is
+// already there and gets 1 or 2 bridges to it, so the bridges connect all
+// isles and never cross. Where the solver can't decide an edge by
+// propagation alone, the bridge counts around it are changed until it can.
+// So a generated puzzle never needs guessing, which also proves that its
+// solution is unique.
+class Generator {
+ public:
+  // Puzzles of width x height cells of which about density (up to 0.2) are
+  // isles.
+  Generator(size_t width, size_t height, double density);
+
+  // Generates the puzzle for seed, the same seed gives the same puzzle.
+  // Returns false if there was none after a few attempts (then the board is
+  // probably too small).
+  bool generate(uint64_t seed, Puzzle* puzzle);
+
+ private:
+  // Starts over with one isle on a random cell.
+  void reset();
+
+  // Adds isles until there are enough or none fits anymore.
+  void grow();
+
+  // Tries to put a new isle in sight of isle i, returns true on success.
+  bool growFrom(size_t i);
+
+  // Returns true if the cells strictly in between isles a and b (which are
+  // in the same row or column) have no isle and no bridge.
+  bool pathFree(size_t a, size_t b) const;
+
+  // Adds count bridges between isles a and b and marks the cells they cover.
+  void addBridge(size_t a, size_t b, int count);
+
+  // Runs the solver on the puzzle and changes the bridges around the edges
+  // it can't decide, until it decides all of them. Returns false if that
+  // doesn't happen within a few rounds.
+  bool makeUnique();
+
+  // Copies the isles sorted by position into puzzle.
+  void buildPuzzle(Puzzle* puzzle) const;
+
+  // Key of the bridge between isles a and b in _bridgeIndex.
+  static uint64_t pairKey(size_t a, size_t b);
+
+  size_t _width;
+  size_t _height;
+  size_t _targetIsles;
+
+  // Longest bridge a new isle gets, so the isles don't spread out too far.
+  size_t _maxLength;
+
+  std::mt19937_64 _random;
+
+  // The isle on every cell (-1 if none) and whether a bridge covers it.
+  std::vector<int> _cells;
+  std::vector<char> _covered;
+
+  // The isles and the bridges of the solution.
+  std::vector<size_t> _x;
+  std::vector<size_t> _y;
+  std::vector<int> _value;
+  std::unordered_map<uint64_t, int> _bridges;
+
+  // The isles in the order of the puzzle (sorted by x, then y).
+  std::vector<size_t> _order;
+};
+
+#endif  // GENERATOR_H_
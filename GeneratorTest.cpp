@@ -0,0 +1,77 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include "./Generator.h"
+#include "./Puzzle.h"
+#include "./Solver.h"
+
+// ____________________________________________________________________________
+TEST(GeneratorTest, generate) {
+  Generator generator(20, 15, 0.15);
+  for (uint64_t seed = 1; seed <= 50; seed++) {
+    Puzzle puzzle;
+    ASSERT_TRUE(generator.generate(seed, &puzzle)) << seed;
+    ASSERT_EQ(20u, puzzle.getWidth());
+    ASSERT_EQ(15u, puzzle.getHeight());
+    ASSERT_EQ(45u, puzzle.numIsles());
+    for (size_t i = 0; i < puzzle.numIsles(); i++) {
+      ASSERT_LE(1, puzzle.getIsle(i).value);
+      ASSERT_GE(8, puzzle.getIsle(i).value);
+    }
+    // Propagation alone solves it, so there is no other solution.
+    Solver solver(puzzle);
+    ASSERT_TRUE(solver.deduce());
+    for (size_t e = 0; e < solver.numEdges(); e++) {
+      ASSERT_TRUE(solver.isDecided(e));
+    }
+    ASSERT_EQ(1u, solver.countSolutions(2)) << seed;
+  }
+
+  // The same seed gives the same puzzle.
+  Puzzle first;
+  Puzzle second;
+  ASSERT_TRUE(generator.generate(7, &first));
+  ASSERT_TRUE(Generator(20, 15, 0.15).generate(7, &second));
+  ASSERT_EQ(first.numIsles(), second.numIsles());
+  for (size_t i = 0; i < first.numIsles(); i++) {
+    ASSERT_EQ(first.getIsle(i).x, second.getIsle(i).x);
+    ASSERT_EQ(first.getIsle(i).y, second.getIsle(i).y);
+    ASSERT_EQ(first.getIsle(i).value, second.getIsle(i).value);
+  }
+
+  // Too small for two isles.
+  Puzzle puzzle;
+  ASSERT_FALSE(Generator(1, 2, 0.15).generate(1, &puzzle));
+}
+
+// ____________________________________________________________________________
+TEST(GeneratorTest, writeAndLoad) {
+  Puzzle puzzle;
+  ASSERT_TRUE(Generator(40, 30, 0.1).generate(3, &puzzle));
+  std::string error;
+  for (bool plain : {false, true}) {
+    std::string filename = plain ? "/tmp/GeneratorTest.plain"
+                                 : "/tmp/GeneratorTest.xy";
+    ASSERT_TRUE(puzzle.write(filename, plain, &error)) << error;
+    Puzzle loaded;
+    ASSERT_TRUE(loaded.load(filename, &error)) << error;
+    remove(filename.c_str());
+    ASSERT_EQ(40u, loaded.getWidth());
+    ASSERT_EQ(30u, loaded.getHeight());
+    ASSERT_EQ(puzzle.numIsles(), loaded.numIsles());
+    // Both formats list the isles in a different order, so compare sums.
+    size_t expected = 0;
+    size_t actual = 0;
+    for (size_t i = 0; i < puzzle.numIsles(); i++) {
+      const PuzzleIsle& a = puzzle.getIsle(i);
+      const PuzzleIsle& b = loaded.getIsle(i);
+      expected += (a.y * 40 + a.x) * a.value;
+      actual += (b.y * 40 + b.x) * b.value;
+    }
+    ASSERT_EQ(expected, actual);
+  }
+  ASSERT_FALSE(puzzle.write("/does/not/exist.xy", false, &error));
+}
@@ -2,24 +2,58 @@
 // Mail: <tomkre13@gmail.com>
 
 #include <getopt.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <ncurses.h>
 #include <unistd.h>
-#include <map>
-#include <algorithm>
-#include <utility>
 #include <string>
-#include <vector>
-#include <fstream>
 #include <iostream>
+#include "./FixedBoard.h"
+#include "./GameView.h"
 #include "./Hashi.h"
-#include "./Object.h"
+#include "./Puzzle.h"
+#include "./Session.h"
+#include "./Stats.h"
+#include "./Solver.h"
+#include "./Verifier.h"
+
+// The game and the sessions have their own names for the keys of ncurses.
+static_assert(kKeyDown == KEY_DOWN && kKeyUp == KEY_UP &&
+              kKeyLeft == KEY_LEFT && kKeyRight == KEY_RIGHT &&
+              kKeyMouse == KEY_MOUSE && kKeyResize == KEY_RESIZE,
+              "the keys of Session.h are the ones of ncurses");
+static_assert(kButton1Clicked == BUTTON1_CLICKED,
+              "the button of Session.h is the one of ncurses");
+
+// How long the 'Victory!!!' stays in one colour.
+static const int kBlinkMillis = 500;
+
+// Where the stats go at the exit and on SIGUSR1 (see --stats), and whether
+// the signal came.
+static std::string statsFileName;
+static volatile sig_atomic_t statsRequested = 0;
+
+// Writes the stats of the game to statsFileName.
+static void dumpStats() {
+  std::string error;
+  if (!gameStats().dump(statsFileName, &error)) {
+    std::cerr << error << std::endl;
+  }
+}
+
+// Only remembers the signal, play() writes the stats.
+static void requestStats(int) { statsRequested = 1; }
 
 // ____________________________________________________________________________
 Hashi::Hashi() {
   _undos = 5;
   _inputFileName = "";
+  _solveOnly = false;
+  _checkOnly = false;
+  _threads = 1;
+  _countLimit = 0;
 }
 
 // ____________________________________________________________________________
@@ -32,7 +66,22 @@ void Hashi::printUsageAndExit() const {
   fprintf(stderr, "Usage: ./HashiMain (--undo (number)) <inputfile>\n");
   fprintf(stderr, "Available options:\n");
   fprintf(stderr, "-u <integer> : Set the amount of available undos.\n");
-  fprintf(stderr, "(default: 5)\n");
+  fprintf(stderr, "(default: 5, -1 for unlimited)\n");
+  fprintf(stderr, "-s : Solve <inputfile> without a window and write the\n");
+  fprintf(stderr, "     bridges to <inputfile>.solution.\n");
+  fprintf(stderr, "-t <integer> : Amount of threads for -s (default: 1).\n");
+  fprintf(stderr, "<inputfile> may also be a *.hashi snapshot, saved with\n");
+  fprintf(stderr, "     the w key, to resume the game.\n");
+  fprintf(stderr, "-c <solutionfile> : Check the solution for <inputfile>\n");
+  fprintf(stderr, "     without a window.\n");
+  fprintf(stderr, "-n[<integer>] : Count the solutions of <inputfile> up to\n");
+  fprintf(stderr, "     the limit (default: 2, enough to check uniqueness).\n");
+  fprintf(stderr, "-S[<file>] : Record how long the game takes for what\n");
+  fprintf(stderr, "     and write it to the file at the exit and on\n");
+  fprintf(stderr, "     SIGUSR1, as JSON if it ends in .json (default:\n");
+  fprintf(stderr, "     hashi-stats.txt). The p key turns it on and off.\n");
+  fprintf(stderr, "-R <file> : Record every input with its time to the\n");
+  fprintf(stderr, "     file, ./HashiReplayMain plays it again.\n");
   endwin();
   exit(1);
 }
@@ -41,6 +90,12 @@ void Hashi::printUsageAndExit() const {
 void Hashi::parseCommandLineArguments(int argc, char** argv) {
   struct option options[] = {
     {"undo", 1, NULL, 'u'},
+    {"solve", 0, NULL, 's'},
+    {"check", 1, NULL, 'c'},
+    {"threads", 1, NULL, 't'},
+    {"count-solutions", 2, NULL, 'n'},
+    {"stats", 2, NULL, 'S'},
+    {"record", 1, NULL, 'R'},
     {NULL, 0, NULL, 0}
   };
   optind = 1;
@@ -48,15 +103,42 @@ void Hashi::parseCommandLineArguments(int argc, char** argv) {
   // Default values.
   _undos = 5;
   _inputFileName = "";
+  _solveOnly = false;
+  _checkOnly = false;
+  _threads = 1;
+  _countLimit = 0;
+  _statsFileName = "";
+  _recordFileName = "";
 
   while (true) {
     // convert all elements in the command line without the filename.
-    char c = getopt_long(argc, argv, "u", options, NULL);
+    char c = getopt_long(argc, argv, "u:sc:t:n::S::R:", options, NULL);
     if (c == -1) { break; }
     switch (c) {
       case 'u':
         _undos = atoi(optarg);
         break;
+      case 's':
+        _solveOnly = true;
+        break;
+      case 't':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        _threads = atoi(optarg);
+        break;
+      case 'n':
+        if (optarg != NULL && atoi(optarg) < 1) { printUsageAndExit(); }
+        _countLimit = optarg == NULL ? 2 : atoi(optarg);
+        break;
+      case 'c':
+        _checkOnly = true;
+        _inputSolutionFileName = optarg;
+        break;
+      case 'S':
+        _statsFileName = optarg == NULL ? "hashi-stats.txt" : optarg;
+        break;
+      case 'R':
+        _recordFileName = optarg;
+        break;
       default:
         printUsageAndExit();
     }
@@ -90,494 +172,251 @@ void Hashi::initializeGame() {
   // Red for value < 0.
   init_pair(3, COLOR_RED, COLOR_BLACK);
 
-  Isle* isle = nullptr;
-  // This vector contains all important information for sub-class Isle.
-  std::vector<int> tmp_isle;
-  tmp_isle.resize(3);
-
-  // Open file and check whether it worked.
-  std::ifstream file(_inputFileName.c_str());
-  if (!file.is_open()) {
-    std::cerr << "Error opening file: " << _inputFileName << std::endl;
-    endwin();
-    exit(1);
-  }
-
-  int cnt = -1;
-  std::string line;
-
-  if (_inputFileName.substr(_inputFileName.find_last_of('.')) == ".plain") {
-    // If we got a *.plain file.
-    while (true) {
-      cnt++;
-      std::getline(file, line);
-      // Don't care about comments.
-      if (line[0] == '#') { continue; }
-      // Stop as we reach the end of the file.
-      if (file.eof()) { break; }
-      for (size_t i = 1; i < line.length()+1; i++) {
-        // Look at every sign in the file and if it isn't a whitespace we can
-        // create a new isle.
-        if (line[i-1] != ' ') {
-          tmp_isle[0] = 5 * i;
-          tmp_isle[1] = 5 * cnt;
-          tmp_isle[2] = stoi(line.substr(i-1, 1));
-          isle = new Isle();
-          isle->new_isle(tmp_isle);
-          _isles.push_back(isle);
-          isle = nullptr;
-        }
-      }
-    }
-  } else if (_inputFileName.substr(_inputFileName.find_last_of('.')) == ".xy") {
-    // Here the similiar procedure for a *.xy file.
-    while (true) {
-      std::getline(file, line);
-      if (line[0] == '#') { continue; }
-      // Comments are useless.
-      if (file.eof()) { break; }
-      // Stop as if we reach the end of file.
-
-      // Every line is: x, y, value.
-      size_t pos1 = line.find(",");
-      size_t pos2 = line.find(",", pos1+1);
-
-      tmp_isle[0] = 5 * (stoi(line.substr(0, pos1)) + 1);
-      // x coordinate
-      tmp_isle[1] = 5 * (stoi(line.substr(pos1 + 1, pos2 - pos1 - 1)) + 1);
-      // y coordinate
-      tmp_isle[2] = stoi(line.substr(pos2 + 1));
-      // value
-
-      isle = new Isle();
-      isle->new_isle(tmp_isle);
-      _isles.push_back(isle);
-      isle = nullptr;
+  readInstance();
+  _view.resize(COLS, LINES);
+  if (!_statsFileName.empty()) { startStats(); }
+  // A recording which is already open goes on.
+  if (!_recordFileName.empty() && !_recorder.isOpen()) {
+    std::string error;
+    if (!_recorder.open(_recordFileName, _inputFileName, _undos, COLS, LINES,
+                        &error)) {
+      std::cerr << error << std::endl;
+      endwin();
+      exit(1);
     }
   }
 }
 
 // ____________________________________________________________________________
-void Hashi::printAround(size_t y, size_t x) {
-  for (int i = -1; i < 2; i++) {
-    for (int j = -1; j < 2; j++) {
-      mvprintw(y+j, x+i, " ");
-    }
-  }
+void Hashi::startStats() {
+  // The handlers are only registered once, afterwards p decides whether
+  // the stats are on.
+  static bool started = false;
+  if (started) { return; }
+  started = true;
+#ifndef HASHI_STATS
+  std::cerr << "The stats aren't compiled in, see STATS in the Makefile"
+            << std::endl;
+#endif
+  statsFileName = _statsFileName;
+  gameStats().setEnabled(true);
+  atexit(dumpStats);
+  signal(SIGUSR1, requestStats);
 }
 
 // ____________________________________________________________________________
-void Hashi::play() {
-  bool vic_flag = false;
-  // flag to get the 'Victory!!!' blinking.
-  while (true) {
-    int key = getch();
-    // pressed key.
-    processUserInput(key);
-    // convert the information, key is giving.
-    showState();
-    // show actual state.
-    if (victory()) {
-      // if we finished we print a blinking 'victory!!!' out.
-      vic_flag = !vic_flag;
-      if (vic_flag) {
-        color_set(1, 0);
-      } else {
-        color_set(2, 0);
-      }
-      mvprintw(0, 0, "Victory!!!");
-    }
-    refresh();
+void Hashi::readInstance() {
+  std::string error;
+  if (!_view.load(_inputFileName, _undos, &error)) {
+    std::cerr << error << std::endl;
+    endwin();
+    exit(1);
   }
 }
 
 // ____________________________________________________________________________
-void Hashi::processUserInput(int key) {
-  MEVENT event;
-  switch (key) {
-    case 27:
-      // End programm with Escape.
-      endwin();
-      exit(1);
-      break;
-    case 'u':
-      // undo a bridge when u is pressed.
-      undo();
-      break;
-    case 's':
-      // If you press s you can give the programm a solution file and it shows
-      // the correct solution.
-      endwin();
-      // first close the ncurses window.
-      std::cout << "Enter file: ";
-      // Help the user, what to do next.
-      std::cin >> _inputSolutionFileName;
-      // Read the text and save it as solution file.
-      _isles.clear();
-      _bridges.clear();
-      // before we start the window again and initialize all isles again,
-      // we need to clear the old isles and bridges, so we don't have it twice.
-      initializeGame();
-      solve(_inputSolutionFileName);
-      break;
-    case KEY_MOUSE:
-      // convert the mouse click.
-      if (getmouse(&event) == OK) {
-        if (event.bstate & BUTTON1_CLICKED) {
-          _startIsleX = _lastClickedX;
-          _startIsleY = _lastClickedY;
-          _lastClickedX = event.x;
-          _lastClickedY = event.y;
-          newBridge(_startIsleX, _startIsleY, _lastClickedX, _lastClickedY);
-          attron(A_REVERSE);
-        }
-      }
-      break;
+bool Hashi::solveMode() const { return _solveOnly; }
+
+// Solves a puzzle on a FixedBoard and writes the solution, for
+// visitFixedBoard().
+struct FixedSolve {
+  const std::string* filename;
+  bool solved;
+  bool written;
+  size_t nodes;
+  std::string error;
+
+  template <typename FixedBoardType>
+  void operator()(FixedBoardType* board) {
+    solved = board->solve();
+    nodes = board->getNodes();
+    if (solved) { written = board->writeSolution(*filename, &error); }
   }
-}
+};
 
 // ____________________________________________________________________________
-void Hashi::newBridge(int startX, int startY, int endX, int endY) {
-  Bridge* bridge = nullptr;
-  std::vector<int> tmp_bridge;
-  // contains all information the sub-class Bridge needs.
-  tmp_bridge.resize(4);
-
-  _start = isIsle(startX, startY);
-  // checks whether the clicked point is on a isle and returns the coordinates
-  // of the isle if it is.
-  _end = isIsle(endX, endY);
-
-  if (startX == -1 && startY == -1) { return; }
-  // Don't create a bridge if it is the first click.
-
-  if ((_start.first == 0 && _start.second == 0) ||
-      (_end.first == 0 && _end.second == 0)) { return; }
-  // Also return if one of the last to clicks isn't on an isle.
-
-  if (_start.first == _end.first && _start.second == _end.second) { return; }
-  // Return if both clicks are on the same isle.
-
-  if (_start.first != _end.first && _start.second != _end.second) { return; }
-  // We can only create vertical or horizontal bridges.
-
-  if (blocked(_start, _end)) { return; }
-  // Can't create a bridge over a third isle.
-
-  tmp_bridge[0] = _start.first;
-  tmp_bridge[1] = _start.second;
-  tmp_bridge[2] = _end.first;
-  tmp_bridge[3] = _end.second;
-
-  int flag = 0;
-  // The amount of bridges between the two given isles.
-  flag = checkBridge(_start, _end);
-
-  if (flag > 1) { return; }
-  // Return if we already got two bridges between the isles.
-
-  bridge = new Bridge();
-  bridge->new_bridge(tmp_bridge);
-  _bridges.push_back(bridge);
-  if (_undo_bridges.size() < (unsigned)_undos) {
-    // Prepare the vector vor the undo function.
-    _undo_bridges.push_back(bridge);
-  } else if (_undo_bridges.size() >= (unsigned)_undos) {
-    _undo_bridges.erase(_undo_bridges.begin());
-    _undo_bridges.push_back(bridge);
+int Hashi::solveHeadless() {
+  Puzzle puzzle;
+  std::string error;
+  if (!puzzle.load(_inputFileName, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
   }
-  bridge = nullptr;
-
-  _lastClickedX = -1;
-  _lastClickedY = -1;
-  countDownUp(_end, false);
-  countDownUp(_start, false);
-  // All done? So reset your latest clicks and countdown the value of the
-  // both isles.
-
-  drawBridge();
-  // Draw the new state of the bridges.
-}
-
-// ____________________________________________________________________________
-void Hashi::drawBridge() {
-  std::pair<size_t, size_t> start;
-  std::pair<size_t, size_t> end;
-  for (auto& bridge : _bridges) {
-    // We always draw every bridge new.
-    // So after an undo we just have to call drawBridge() and the bridge
-    // disappears.
-    int flag = 0;
-    start = bridge->getStart();
-    end = bridge->getEnd();
-    flag = checkBridge(start, end) - 1;
-    if (flag > 1) { continue; }
-    // Normally this should never happen, because we check it already
-    // in the newBridge()-function.
-
-    if (start.first == end.first) {
-      // If we want to draw a horizontal bridge.
-      if (start.second < end.second) {
-        // And we we have to draw down.
-        for (size_t i = start.second; i < end.second; i++) {
-          if (flag == 1) {
-            // Already exists one bridge.
-            mvprintw(i, start.first, "H");
-          } else if (flag == 0) {
-            // The first bridge between the isles.
-            mvprintw(i, start.first, "|");
-          }
-        }
-      } else {
-        for (size_t i = end.second; i < start.second; i++) {
-          if (flag == 1) {
-            mvprintw(i, start.first, "H");
-          } else if (flag == 0) {
-            mvprintw(i, start.first, "|");
-          }
-        }
-      }
-    } else if (start.second == end.second) {
-      // If we want to draw a horizontal bridge.
-      if (start.first < end.first) {
-        for (size_t i = start.first; i < end.first; i++) {
-          if (flag == 1) {
-            mvprintw(start.second, i, "=");
-          } else if (flag == 0) {
-            mvprintw(start.second, i, "-");
-          }
-        }
-      } else {
-        for (size_t i = end.first; i < start.first; i++) {
-          if (flag == 1) {
-            mvprintw(start.second, i, "=");
-          } else if (flag == 0) {
-            mvprintw(start.second, i, "-");
-          }
-        }
-      }
+  std::string solutionFileName = _inputFileName + ".solution";
+  // Small puzzles are solved on a FixedBoard, without threads.
+  FixedSolve fixed = {&solutionFileName, false, false, 0, ""};
+  size_t nodes;
+  if (visitFixedBoard(puzzle, &fixed)) {
+    if (!fixed.solved) {
+      std::cerr << "No solution for " << _inputFileName << std::endl;
+      return 1;
+    }
+    if (!fixed.written) {
+      std::cerr << fixed.error << std::endl;
+      return 1;
+    }
+    nodes = fixed.nodes;
+  } else {
+    Solver solver(puzzle);
+    if (!solver.solveParallel(_threads)) {
+      std::cerr << "No solution for " << _inputFileName << std::endl;
+      return 1;
+    }
+    if (!solver.writeSolution(solutionFileName, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
     }
+    nodes = solver.getNodes();
   }
+  std::cout << "Solved " << _inputFileName << " (" << puzzle.numIsles()
+            << " isles, " << nodes << " search nodes), wrote "
+            << solutionFileName << std::endl;
+  return 0;
 }
 
 // ____________________________________________________________________________
-int Hashi::checkBridge(std::pair<size_t, size_t> s,
-                       std::pair<size_t, size_t> e) {
-  int flag = 0;
-  std::pair<size_t, size_t> tmp_start;
-  std::pair<size_t, size_t> tmp_end;
-
-  for (auto& brid : _bridges) {
-    // Compare the new bridge to every already existing bridge.
-    tmp_start = brid->getStart();
-    tmp_end = brid->getEnd();
-    if ((tmp_start.first == s.first &&
-        tmp_start.second == s.second &&
-        tmp_end.first == e.first &&
-        tmp_end.second == e.second) ||
-        (tmp_end.first == s.first &&
-        tmp_end.second == s.second &&
-        tmp_start.first == e.first &&
-        tmp_start.second == e.second)) {
-      flag++;
-      // Count up for every similiar bridge.
-    }
-  }
-  return flag;
-}
+bool Hashi::checkMode() const { return _checkOnly; }
 
 // ____________________________________________________________________________
-bool Hashi::blocked(std::pair<size_t, size_t> start,
-                    std::pair<size_t, size_t> end) {
-  if (start.first == end.first) {
-    // same if and for clauses as already described at drawBridge()
-    if (start.second < end.second) {
-      for (size_t i = start.second + 1; i < end.second - 1; i++) {
-        for (auto& isle : _isles) {
-          if (isle->getX() == start.first && isle->getY() == i) {
-            // if another isle is where the bridge should be built,
-            // return true for 'yes, the way is blocked'.
-            return true;
-          }
-        }
-      }
-    } else {
-      for (size_t i = end.second + 1; i < start.second - 1; i++) {
-        for (auto& isle : _isles) {
-          if (isle->getX() == start.first && isle->getY() == i) {
-            return true;
-          }
-        }
-      }
-    }
-  } else if (start.second == end.second) {
-    if (start.first < end.first) {
-      for (size_t i = start.first + 1; i < end.first - 1; i++) {
-        for (auto& isle : _isles) {
-          if (isle->getX() == i && isle->getY() == start.second) {
-            return true;
-          }
-        }
-      }
-    } else {
-      for (size_t i = end.first + 1; i < start.first - 1; i++) {
-        for (auto& isle : _isles) {
-          if (isle->getX() == i && isle->getY() == start.second) {
-            return true;
-          }
-        }
-      }
-    }
-  }
-  return false;
+int Hashi::checkHeadless() {
+  // The same check as HashiVerifyMain does for many files.
+  Verdict verdict = verifySolution(_inputFileName, _inputSolutionFileName);
+  std::cout << resultName(verdict.result) << " " << _inputSolutionFileName;
+  if (!verdict.message.empty()) { std::cout << ": " << verdict.message; }
+  std::cout << std::endl;
+  return verdict.result == Verdict::CORRECT ? 0 : 1;
 }
 
 // ____________________________________________________________________________
-std::pair<size_t, size_t> Hashi::isIsle(size_t x, size_t y) {
-  for (auto& isle : _isles) {
-    // We compare our mouse click position to every existing isle.
-    for (int i = -1; i < 2; i++) {
-      for (int j = -1; j < 2; j++) {
-        // With this for loops, a 3x3 clicking window gets created.
-        if (y+j == isle->getY() && x+i == isle->getX()) {
-          return std::pair<size_t, size_t>(isle->getX(), isle->getY());
-        }
-      }
-    }
-  }
-  return std::pair<size_t, size_t>(0, 0);
-  // The function needs a return value.
-}
+bool Hashi::countMode() const { return _countLimit > 0; }
 
 // ____________________________________________________________________________
-void Hashi::countDownUp(std::pair<size_t, size_t> s, bool plus) {
-  for (auto& elem : _isles) {
-    if (!plus) {
-      // Everytime we build a bridge we count the value of the
-      // involved isles one down.
-      if (elem->getX() == s.first && elem->getY() == s.second) {
-        elem->changeValue(false);
-      }
-    } else {
-      // Otherwise we undo a bridge and count the value one up.
-      if (elem->getX() == s.first && elem->getY() == s.second) {
-        elem->changeValue(true);
-      }
-    }
+int Hashi::countHeadless() {
+  Puzzle puzzle;
+  std::string error;
+  if (!puzzle.load(_inputFileName, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
   }
+  Solver solver(puzzle);
+  size_t count = solver.countSolutions(_countLimit);
+  // Reaching the limit means there may be more.
+  bool unique = count == 1 && _countLimit > 1;
+  std::cout << _inputFileName << ": ";
+  if (count == _countLimit) { std::cout << "at least "; }
+  std::cout << count << (count == 1 ? " solution" : " solutions");
+  if (unique) { std::cout << " (unique)"; }
+  std::cout << " (" << solver.getNodes() << " search nodes, "
+            << solver.getTableHits() << " table hits)" << std::endl;
+  return unique ? 0 : 1;
 }
 
 // ____________________________________________________________________________
-void Hashi::undo() {
-  if (_undo_bridges.empty()) { return; }
-  // Nobody has start playing so we can't undo something.
-  std::pair<size_t, size_t> start;
-  std::pair<size_t, size_t> end;
-  auto& erase = _bridges.back();
-  // undo the latest built bridge.
-  start = erase->getStart();
-  end = erase->getEnd();
-  if (start.first == end.first) {
-    // Erase a vertical bridge.
-    if (start.second < end.second) {
-      for (size_t i = start.second; i < end.second; i++) {
-        mvprintw(i, start.first, " ");
-      }
-    } else {
-      for (size_t i = end.second; i < start.second; i++) {
-        mvprintw(i, start.first, " ");
-      }
+void Hashi::play() {
+  bool vic_flag = false;
+  // flag to get the 'Victory!!!' blinking.
+  struct pollfd input;
+  input.fd = STDIN_FILENO;
+  input.events = POLLIN;
+  // A snapshot of a finished game starts with the 'Victory!!!'.
+  if (_view.victory()) { _view.showStatus("Victory!!!"); }
+  showState();
+  refresh();
+  while (true) {
+    // Sleep until the user does something. Only if we have won we wake up
+    // regularly to let the 'Victory!!!' blink.
+    int timeout = _view.victory() ? kBlinkMillis : -1;
+    int ready = poll(&input, 1, timeout);
+    if (statsRequested) {
+      statsRequested = 0;
+      dumpStats();
     }
-  } else if (start.second == end.second) {
-    // erase a horizontal bridge.
-    if (start.first < end.first) {
-      for (size_t i = start.first; i < end.first; i++) {
-        mvprintw(start.second, i, " ");
-      }
-    } else {
-      for (size_t i = end.first; i < start.first; i++) {
-        mvprintw(start.second, i, " ");
+    if (ready != 0) {
+      // Input (or a signal like a resize): handle every key which is
+      // waiting, getch() doesn't block because of nodelay().
+      int key;
+      while ((key = getch()) != ERR) {
+        processUserInput(key);
+        // convert the information, key is giving.
       }
+    } else if (_view.victory()) {
+      // The blink timer ran out, the 'Victory!!!' of handleEvent() changes
+      // its colour.
+      vic_flag = !vic_flag;
+      _view.showStatus("Victory!!!", vic_flag ? 1 : 2);
     }
+    showState();
+    // show actual state.
+    STAT_TIMER(STAT_REFRESH);
+    refresh();
   }
-  countDownUp(start, true);
-  countDownUp(end, true);
-  _undo_bridges.pop_back();
-  _bridges.pop_back();
-  drawBridge();
 }
 
 // ____________________________________________________________________________
-int Hashi::victory() {
-  int vic_flag = 1;
-  for (auto& isle : _isles) {
-    // All values are 0, you won.
-    if (isle->getValue() != 0) {
-      return vic_flag = 0;
-    }
+void Hashi::processUserInput(int key) {
+  // Everything handleEvent() needs to know from ncurses goes into the
+  // event, so it can be recorded and replayed.
+  SessionEvent event = SessionEvent{0, key, false, 0, 0, 0};
+  if (key == kKeyMouse) {
+    MEVENT mouse;
+    if (getmouse(&mouse) != OK) { return; }
+    event.hasPosition = true;
+    event.x = mouse.x;
+    event.y = mouse.y;
+    event.buttons = mouse.bstate;
+  } else if (key == kKeyResize) {
+    event.hasPosition = true;
+    event.x = COLS;
+    event.y = LINES;
+  } else if (key == 's') {
+    // Ask for the solution file on the terminal. The name goes into the
+    // event, so a replay loads the same file.
+    endwin();
+    std::cout << "Enter file: ";
+    std::cin >> event.text;
+    // Back to the window, which is drawn again from scratch.
+    refresh();
+    clear();
   }
-  return vic_flag;
+  _recorder.record(event);
+  handleEvent(event);
 }
 
 // ____________________________________________________________________________
-void Hashi::solve(const std::string& filename) {
-  // Open file and check whether it worked or not.
-  std::ifstream file(filename.c_str());
-  if (!file.is_open()) {
-    std::cerr << "Error opening file: " << filename << std::endl;
-    endwin();
-    exit(1);
-  }
-
-  std::string line;
-
-  if (filename.substr(filename.find_last_of('.')) == ".solution") {
-    // Looking for a *.solution file.
-    while (true) {
-      std::getline(file, line);
-      if (line[0] == '#') { continue; }
-      // Don't care about comments.
-      if (file.eof()) { break; }
-      // Stop as we reach the end of the file.
-      size_t pos1 = line.find(",");
-      size_t pos2 = line.find(",", pos1+1);
-      size_t pos3 = line.find(",", pos2+1);
-
-      _startIsleX = 5 * (stoi(line.substr(0, pos1)) + 1);
-      _startIsleY = 5 * (stoi(line.substr(pos1 + 1, pos2 - pos1 - 1)) + 1);
-      // Start isle.
-      _lastClickedX = 5 * (stoi(line.substr(pos2 + 1, pos3 - pos2 - 1)) + 1);
-      _lastClickedY = 5 * (stoi(line.substr(pos3 + 1)) + 1);
-      // End isle.
-
-      newBridge(_startIsleX, _startIsleY, _lastClickedX, _lastClickedY);
-    }
-  }
-  if (victory() == 0) {
-    // In case something didn't work out with the solution file.
-    mvprintw(0, 0, "%s is the wrong solution file,", filename.c_str());
-    mvprintw(1, 0, "or at least one bridge is built the wrong way.");
+void Hashi::handleEvent(const SessionEvent& event) {
+  std::string text;
+  switch (event.key) {
+    case kKeyEscape:
+      // End programm with Escape.
+      endwin();
+      exit(1);
+      break;
+    case kKeyResize:
+      // The terminal is written again from scratch.
+      clear();
+      break;
+    case 'p':
+      // Turn the stats of --stats on and off.
+      if (!_statsFileName.empty()) {
+        gameStats().setEnabled(!gameStats().enabled());
+        text = gameStats().enabled() ? "Stats on" : "Stats off";
+      }
+      break;
   }
+  _view.handleEvent(event);
+  // The 'Victory!!!' goes first.
+  if (!text.empty() && !_view.victory()) { _view.showStatus(text); }
 }
 
 // ____________________________________________________________________________
 void Hashi::showState() {
-  attron(A_REVERSE);
-  for (auto& element : _isles) {
-    color_set(2, 0);
-    // Basic case: Draw white on black.
-    if (element->getValue() == 0) {
-      color_set(1, 0);
-      // Isle has value = 0: Draw green on black.
-    } else if (element->getValue() < 0) {
-      color_set(3, 0);
-      // Isle has to many bridges: Draw red on black.
-    }
-    printAround(element->getY(), element->getX());
-    // Draw a 3x3 Isle.
-    mvprintw(element->getY(), element->getX(), "%d", element->getValue());
-  }
-  color_set(2, 0);
+  STAT_TIMER(STAT_SHOW_STATE);
+  STAT_FRAME(_view.canvas().dirtyCells());
+  // Only the cells which changed since the last time go to the terminal.
+  _view.canvas().flush([](size_t x, size_t y, const Cell& cell) {
+    attrset(COLOR_PAIR(cell.color) | (cell.reverse ? A_REVERSE : A_NORMAL));
+    mvaddch(y, x, cell.ch);
+  });
+  attrset(COLOR_PAIR(2));
   // Go back ino basic case.
-  attroff(A_REVERSE);
 }
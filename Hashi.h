@@ -6,12 +6,13 @@
 #define HASHI_H_
 
 
-#include <gtest/gtest.h>
 #include <string>
-#include <utility>
-#include <map>
-#include <vector>
-#include "./Object.h"
+#include "./GameView.h"
+#include "./Session.h"
+
+// The tests of HashiTest.cpp see the private members, like with FRIEND_TEST
+// of gtest, but the game doesn't need gtest for it.
+#define HASHI_TEST(name) friend class HashiTest_##name##_Test
 
 class Hashi {
  public:
@@ -30,55 +31,60 @@ class Hashi {
   // Initialize the game.
   void initializeGame();
 
-  // Prints around (x, y) to create a 3x3 isle.
-  void printAround(size_t y, size_t x);
-
-  // The while (true) - loop, which keeps the game running.
-  void play();
-
-  // Gets the users input and converts it into an action.
-  void processUserInput(int key);
-
-  // Creates a bridge between two isles.
-  void newBridge(int startX, int startY, int endX, int endY);
+  // Returns true if the game was started with --solve.
+  bool solveMode() const;
 
-  // Returns true if a Isle is in the middle of to other isles you
-  // wanted to connect with a bridge.
-  bool blocked(std::pair<size_t, size_t> start, std::pair<size_t, size_t> end);
+  // Solves the input file without ncurses and writes the bridges to
+  // <inputfile>.solution. Returns the exit code for main().
+  int solveHeadless();
 
-  // Checks whether the clicked position is on an isle or not.
-  std::pair<size_t, size_t> isIsle(size_t x, size_t y);
+  // Returns true if the game was started with --check.
+  bool checkMode() const;
 
-  // Decrements _value, when a bridge was build.
-  // And counts up _value if the user wants to undo a bridge.
-  // Plus is true for addition and false for subtraction.
-  void countDownUp(std::pair<size_t, size_t> s, bool plus);
+  // Checks the solution file given by --check against the input file without
+  // ncurses and prints the verdict. Returns 0 if it solves the puzzle.
+  int checkHeadless();
 
-  // Draws the bridges.
-  void drawBridge();
+  // Returns true if the game was started with --count-solutions.
+  bool countMode() const;
 
-  // Check whether we can build another bridge on that isle or not.
-  // Returns the amount of bridges between to isles.
-  int checkBridge(std::pair<size_t, size_t> s, std::pair<size_t, size_t> e);
+  // Counts the solutions of the input file up to the limit of
+  // --count-solutions without ncurses. Returns 0 if there is exactly one.
+  int countHeadless();
 
-  // Undos a bridge (max. _undos times)
-  void undo();
+  // The while (true) - loop, which keeps the game running. It sleeps in
+  // poll() until there is input or the 'Victory!!!' has to blink, so an
+  // idle game doesn't use the CPU.
+  void play();
 
-  // Checks whether the Hashi is solved.
-  int victory();
+  // Gets the users input and converts it into an action. With --record it
+  // is written to the session file first.
+  void processUserInput(int key);
 
-  // Tries to solve the given Hashi with the instructions from filename.
-  void solve(const std::string& filename);
+  // The action of one input, without asking ncurses about it. The game
+  // view does everything but the keys which need the terminal.
+  void handleEvent(const SessionEvent& event);
 
-  // Function for showing the actual state in the window.
+  // Function for showing the actual state in the window. Only the cells of
+  // the canvas which changed are written to the terminal.
   void showState();
 
  private:
-  FRIEND_TEST(HashiTest, setUndoDefault);
-  FRIEND_TEST(HashiTest, parseCommandLineArguments);
-  FRIEND_TEST(HashiTest, setUndoWrongUsage);
+  HASHI_TEST(setUndoDefault);
+  HASHI_TEST(parseCommandLineArguments);
+  HASHI_TEST(parseStatsOption);
+  HASHI_TEST(setUndoWrongUsage);
+  HASHI_TEST(recordAndReplay);
+  HASHI_TEST(statsKey);
+
+  // Reads the isles from _inputFileName into the board.
+  void readInstance();
 
-  // That's how often we can undo something.
+  // Turns the stats on and writes them to _statsFileName at the exit and
+  // on SIGUSR1. Does nothing after the first call.
+  void startStats();
+
+  // That's how often we can undo something (-1 for unlimited).
   int _undos;
 
   // The File Name.
@@ -87,26 +93,29 @@ class Hashi {
   // The Name of the solution file.
   std::string _inputSolutionFileName;
 
-  // Position of the latest click.
-  int _lastClickedX = -1;
-  int _lastClickedY = -1;
+  // True if we only solve the input file with the solver.
+  bool _solveOnly;
+
+  // True if we only check _inputSolutionFileName.
+  bool _checkOnly;
+
+  // Amount of threads of the solver.
+  size_t _threads;
 
-  // Position of the second latest click.
-  int _startIsleX = 0;
-  int _startIsleY = 0;
+  // Limit of --count-solutions, 0 if we don't count.
+  size_t _countLimit;
 
-  // Start and end coordinates of a bridge.
-  std::pair<size_t, size_t> _start;
-  std::pair<size_t, size_t> _end;
+  // The file of --stats, empty without stats.
+  std::string _statsFileName;
 
-  // A vector which contains all actuall isles.
-  std::vector<Isle*> _isles;
+  // The file of --record, empty if we don't record.
+  std::string _recordFileName;
 
-  // A vector which contains all actuall bridges.
-  std::vector<Bridge*> _bridges;
+  // The game as it is shown, see showState().
+  GameView _view;
 
-  // A vector which contains all the bridges we can undo in a row.
-  std::vector<Bridge*> _undo_bridges;
+  // Writes the inputs to _recordFileName.
+  SessionRecorder _recorder;
 };
 
 #endif  // HASHI_H_
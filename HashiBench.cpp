@@ -0,0 +1,216 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <getopt.h>
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./Generator.h"
+#include "./GameView.h"
+#include "./Puzzle.h"
+#include "./Solver.h"
+
+// ____________________________________________________________________________
+static void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./HashiBench [options] (<inputfile>)...\n");
+  fprintf(stderr, "Measures parsing, newBridge() with undo(), victory(),\n");
+  fprintf(stderr, "replaying a solution and rendering into the canvas on\n");
+  fprintf(stderr, "the i0*.xy instances, the input files and generated\n");
+  fprintf(stderr, "boards of growing size. Writes one JSON object per\n");
+  fprintf(stderr, "line and measurement.\n");
+  fprintf(stderr, "Available options:\n");
+  fprintf(stderr, "-m <integer> : Milliseconds per measurement (default:\n");
+  fprintf(stderr, "     100).\n");
+  fprintf(stderr, "-n <integer> : Largest generated board, it starts at\n");
+  fprintf(stderr, "     25 x 25 and doubles (default: 400, 0 for none).\n");
+  fprintf(stderr, "-o <file> : Write to file instead of stdout.\n");
+  exit(2);
+}
+
+// Runs the benchmarks on one instance at a time. It drives the game on a
+// GameView like the tests do, without ncurses.
+class HashiBench {
+ public:
+  // Every measurement runs for at least seconds and is written to out.
+  HashiBench(double seconds, FILE* out) : _seconds(seconds), _out(out) {}
+
+  // Runs all benchmarks on the instance file, name is the instance in the
+  // output. Returns false and writes a message to error if the file can't
+  // be read or has no solution.
+  bool run(const std::string& filename, const std::string& name,
+           std::string* error);
+
+ private:
+  // Calls f(k) for k = 0, 1, ... in batches of doubling size until a batch
+  // took _seconds, then writes the time per call of that batch.
+  template <typename F>
+  void measure(const char* benchmark, F f);
+
+  double _seconds;
+  FILE* _out;
+
+  // The instance which is measured.
+  std::string _name;
+  size_t _isles;
+};
+
+// ____________________________________________________________________________
+template <typename F>
+void HashiBench::measure(const char* benchmark, F f) {
+  size_t iterations = 1;
+  double seconds;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < iterations; k++) { f(k); }
+    seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (seconds >= _seconds || iterations >= (1u << 30)) { break; }
+    iterations *= 2;
+  }
+  fprintf(_out, "{\"benchmark\": \"%s\", \"instance\": \"%s\", "
+                "\"isles\": %zu, \"iterations\": %zu, \"ns_per_op\": %.1f}\n",
+          benchmark, _name.c_str(), _isles, iterations,
+          seconds * 1e9 / iterations);
+  fflush(_out);
+}
+
+// ____________________________________________________________________________
+bool HashiBench::run(const std::string& filename, const std::string& name,
+                     std::string* error) {
+  Puzzle puzzle;
+  if (!puzzle.load(filename, error)) { return false; }
+  _name = name;
+  _isles = puzzle.numIsles();
+  measure("parse", [&filename](size_t) {
+    Puzzle parsed;
+    std::string message;
+    parsed.load(filename, &message);
+  });
+
+  // The bridges of a solution as grid positions, in the order of the
+  // solver's edges.
+  Solver solver(puzzle);
+  if (!solver.solve()) {
+    *error = "No solution for " + filename;
+    return false;
+  }
+  typedef std::pair<size_t, size_t> P;
+  std::vector<std::pair<P, P>> bridges;
+  for (size_t e = 0; e < solver.numEdges(); e++) {
+    const PuzzleIsle& s = puzzle.getIsle(solver.getStart(e));
+    const PuzzleIsle& t = puzzle.getIsle(solver.getEnd(e));
+    for (int k = 0; k < solver.getBridges(e); k++) {
+      bridges.push_back(std::make_pair(P(s.x, s.y), P(t.x, t.y)));
+    }
+  }
+
+  // The game on a screen of 160 x 48 cells at the top left of the board,
+  // with unlimited undos, so a whole solution can be taken back.
+  GameView view;
+  if (!view.load(filename, -1, error)) { return false; }
+  view.resize(160, 48);
+  auto discard = [](size_t, size_t, const Cell&) {};
+  view.canvas().flush(discard);
+
+  measure("new_bridge_undo", [&](size_t k) {
+    const std::pair<P, P>& bridge = bridges[k % bridges.size()];
+    view.newBridge(bridge.first.first, bridge.first.second,
+                   bridge.second.first, bridge.second.second);
+    view.undo();
+  });
+  volatile int won = 0;
+  measure("victory", [&](size_t) { won = won + view.victory(); });
+  measure("replay", [&](size_t) {
+    for (const std::pair<P, P>& bridge : bridges) {
+      view.newBridge(bridge.first.first, bridge.first.second,
+                     bridge.second.first, bridge.second.second);
+    }
+    won = won + view.victory();
+    for (size_t k = 0; k < bridges.size(); k++) { view.undo(); }
+  });
+  measure("render", [&](size_t) {
+    view.drawBoard();
+    view.canvas().flush(discard);
+  });
+  // The hint engine gets every bridge of the game as well.
+  view.game().hints().wait();
+  return true;
+}
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"min-time", 1, NULL, 'm'},
+    {"max-size", 1, NULL, 'n'},
+    {"output", 1, NULL, 'o'},
+    {NULL, 0, NULL, 0}
+  };
+  double seconds = 0.1;
+  size_t maxSize = 400;
+  std::string output;
+  while (true) {
+    int c = getopt_long(argc, argv, "m:n:o:", options, NULL);
+    if (c == -1) { break; }
+    switch (c) {
+      case 'm':
+        seconds = atof(optarg) / 1000;
+        break;
+      case 'n':
+        maxSize = atoi(optarg);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  FILE* out = stdout;
+  if (!output.empty()) {
+    out = fopen(output.c_str(), "w");
+    if (out == NULL) {
+      fprintf(stderr, "Error opening file: %s\n", output.c_str());
+      return 1;
+    }
+  }
+
+  // The shipped instances and the ones of the command line.
+  std::vector<std::string> files;
+  glob_t found;
+  if (glob("i0*.xy", 0, NULL, &found) == 0) {
+    for (size_t k = 0; k < found.gl_pathc; k++) {
+      files.push_back(found.gl_pathv[k]);
+    }
+  }
+  globfree(&found);
+  for (int k = optind; k < argc; k++) { files.push_back(argv[k]); }
+
+  HashiBench bench(seconds, out);
+  std::string error;
+  int result = 0;
+  for (const std::string& file : files) {
+    if (!bench.run(file, file, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      result = 1;
+    }
+  }
+  // Generated boards, which always have a solution.
+  for (size_t size = 25; size <= maxSize; size *= 2) {
+    Puzzle puzzle;
+    Generator(size, size, 0.15).generate(1, &puzzle);
+    std::string name = "synthetic-" + std::to_string(size) + "x" +
+                       std::to_string(size);
+    std::string file = "/tmp/HashiBench-" + name + ".xy";
+    if (!puzzle.write(file, false, &error) || !bench.run(file, name, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      result = 1;
+    }
+    remove(file.c_str());
+  }
+  if (out != stdout) { fclose(out); }
+  return result;
+}
@@ -0,0 +1,88 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include "./Board.h"
+#include "./Puzzle.h"
+#include "./Snapshot.h"
+
+// ____________________________________________________________________________
+static void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./HashiConvertMain [options] <input> <output>\n");
+  fprintf(stderr, "Converts between *.xy, *.plain and *.hashi files, the\n");
+  fprintf(stderr, "format is taken from the ending. The bridges of a\n");
+  fprintf(stderr, "*.hashi input can also be written as a *.solution.\n");
+  fprintf(stderr, "Available options:\n");
+  fprintf(stderr, "-s <solutionfile> : Put these bridges into the *.hashi\n");
+  fprintf(stderr, "     output (or the *.solution output).\n");
+  exit(2);
+}
+
+// Returns the ending of filename with the dot.
+static std::string endingOf(const std::string& filename) {
+  size_t dot = filename.find_last_of('.');
+  return dot == std::string::npos ? "" : filename.substr(dot);
+}
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"solution", 1, NULL, 's'},
+    {NULL, 0, NULL, 0}
+  };
+  std::string solution;
+  while (true) {
+    int c = getopt_long(argc, argv, "s:", options, NULL);
+    if (c == -1) { break; }
+    switch (c) {
+      case 's':
+        solution = optarg;
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind + 2 != argc) { printUsageAndExit(); }
+  std::string input = argv[optind];
+  std::string output = argv[optind + 1];
+
+  Puzzle puzzle;
+  Board board;
+  std::string error;
+  bool ok;
+  if (endingOf(input) == ".hashi") {
+    ok = board.loadSnapshot(input, &puzzle, &error);
+  } else {
+    ok = puzzle.load(input, &error);
+    if (ok) { board.load(puzzle); }
+  }
+  if (ok && !solution.empty()) { ok = board.loadSolution(solution, &error); }
+  if (ok) {
+    std::string ending = endingOf(output);
+    if (ending == ".hashi") {
+      ok = writeSnapshot(output, puzzle, &board, &error);
+    } else if (ending == ".solution") {
+      ok = board.writeSolution(output, &error);
+    } else if (ending == ".xy" || ending == ".plain") {
+      ok = puzzle.write(output, ending == ".plain", &error);
+    } else {
+      error = "Unknown file type: " + output;
+      ok = false;
+    }
+  }
+  if (!ok) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  size_t bridges = 0;
+  for (size_t b = 0; b < board.numBridges(); b++) {
+    bridges += board.getCount(b);
+  }
+  std::cout << "Wrote " << output << " (" << puzzle.numIsles() << " isles, "
+            << bridges << " bridges)" << std::endl;
+  return 0;
+}
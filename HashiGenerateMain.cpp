@@ -0,0 +1,146 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "./Generator.h"
+#include "./Parallel.h"
+#include "./Puzzle.h"
+#include "./Solver.h"
+
+// ____________________________________________________________________________
+static void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./HashiGenerateMain [options]\n");
+  fprintf(stderr, "Generates puzzles with a unique solution and writes\n");
+  fprintf(stderr, "iNNN-nNNN-sWWxHH.xy, .plain and .xy.solution files.\n");
+  fprintf(stderr, "Available options:\n");
+  fprintf(stderr, "-w <integer> : Width of the board (default: 13).\n");
+  fprintf(stderr, "-h <integer> : Height of the board (default: 8).\n");
+  fprintf(stderr, "-d <number> : Share of the cells which are isles\n");
+  fprintf(stderr, "     (default: 0.1, at most 0.2).\n");
+  fprintf(stderr, "-n <integer> : Amount of puzzles (default: 1).\n");
+  fprintf(stderr, "-f <integer> : Number of the first puzzle (default: 1).\n");
+  fprintf(stderr, "-s <integer> : Seed (default: 1), puzzle k gets\n");
+  fprintf(stderr, "     seed + k.\n");
+  fprintf(stderr, "-o <directory> : Where the files go (default: .).\n");
+  fprintf(stderr, "-t <integer> : Amount of threads (default: all cores).\n");
+  exit(2);
+}
+
+// Writes the three files of puzzle number id into directory. Returns false
+// and writes a message to error if that fails.
+static bool writePuzzle(const Puzzle& puzzle, size_t id,
+                        const std::string& directory, std::string* error) {
+  char name[100];
+  snprintf(name, sizeof(name), "i%03zu-n%03zu-s%02zux%02zu", id,
+           puzzle.numIsles(), puzzle.getWidth(), puzzle.getHeight());
+  std::string path = directory + "/" + name;
+  // The solution is the only one, propagation alone finds it.
+  Solver solver(puzzle);
+  if (!solver.deduce()) {
+    *error = path + ": no solution";
+    return false;
+  }
+  return puzzle.write(path + ".xy", false, error) &&
+         puzzle.write(path + ".plain", true, error) &&
+         solver.writeSolution(path + ".xy.solution", error);
+}
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"width", 1, NULL, 'w'},
+    {"height", 1, NULL, 'h'},
+    {"density", 1, NULL, 'd'},
+    {"count", 1, NULL, 'n'},
+    {"first", 1, NULL, 'f'},
+    {"seed", 1, NULL, 's'},
+    {"output", 1, NULL, 'o'},
+    {"threads", 1, NULL, 't'},
+    {NULL, 0, NULL, 0}
+  };
+  size_t width = 13;
+  size_t height = 8;
+  double density = 0.1;
+  size_t count = 1;
+  size_t first = 1;
+  uint64_t seed = 1;
+  std::string directory = ".";
+  size_t threads = hardwareThreads();
+  while (true) {
+    int c = getopt_long(argc, argv, "w:h:d:n:f:s:o:t:", options, NULL);
+    if (c == -1) { break; }
+    switch (c) {
+      case 'w':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        width = atoi(optarg);
+        break;
+      case 'h':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        height = atoi(optarg);
+        break;
+      case 'd':
+        density = atof(optarg);
+        if (density <= 0) { printUsageAndExit(); }
+        break;
+      case 'n':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        count = atoi(optarg);
+        break;
+      case 'f':
+        if (atoi(optarg) < 0) { printUsageAndExit(); }
+        first = atoi(optarg);
+        break;
+      case 's':
+        seed = strtoull(optarg, NULL, 10);
+        break;
+      case 'o':
+        directory = optarg;
+        break;
+      case 't':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        threads = atoi(optarg);
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind != argc) { printUsageAndExit(); }
+
+  // Every puzzle is a job of its own, one generator per thread.
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Generator> generators(threads,
+                                    Generator(width, height, density));
+  std::vector<std::string> errors(count);
+  std::atomic<size_t> isles(0);
+  parallelFor(count, threads, [&](size_t job, size_t worker) {
+    Puzzle puzzle;
+    if (!generators[worker].generate(seed + first + job, &puzzle)) {
+      errors[job] = "no puzzle found for number " +
+                    std::to_string(first + job);
+      return;
+    }
+    isles += puzzle.numIsles();
+    writePuzzle(puzzle, first + job, directory, &errors[job]);
+  });
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  size_t failed = 0;
+  for (const std::string& error : errors) {
+    if (error.empty()) { continue; }
+    std::cerr << error << std::endl;
+    failed++;
+  }
+  std::cout << "Generated " << count - failed << " puzzles (" << isles
+            << " isles) with " << threads << " threads in " << seconds
+            << "s: " << (count - failed) / seconds << " puzzles/s, "
+            << isles / seconds << " isles/s" << std::endl;
+  return failed == 0 ? 0 : 1;
+}
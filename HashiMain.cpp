@@ -9,10 +9,14 @@
 int main(int argc, char** argv) {
   Hashi hashi;
   hashi.parseCommandLineArguments(argc, argv);
+  if (hashi.solveMode()) { return hashi.solveHeadless(); }
+  if (hashi.checkMode()) { return hashi.checkHeadless(); }
+  if (hashi.countMode()) { return hashi.countHeadless(); }
   hashi.initializeGame();
   refresh();
   hashi.play();
   // First we read in a given file with parseCommandLineArguments.
+  // With --solve the solver writes the solution and we never open a window.
   // Then we convert the information from the file with initializeGame.
   // After that we only call our play function where we get caught
   // in a while loop, so we can play the game.
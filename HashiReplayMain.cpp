@@ -0,0 +1,149 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./GameView.h"
+#include "./Session.h"
+
+// ____________________________________________________________________________
+static void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./HashiReplayMain [options] <sessionfile>\n");
+  fprintf(stderr, "Plays a session recorded by ./HashiMain --record again,\n");
+  fprintf(stderr, "without a window and as fast as possible. Writes one\n");
+  fprintf(stderr, "JSON object per line and event with how long it took,\n");
+  fprintf(stderr, "and a summary per key to stderr.\n");
+  fprintf(stderr, "Available options:\n");
+  fprintf(stderr, "-r <integer> : Play it that often and take the fastest\n");
+  fprintf(stderr, "     time of every event (default: 1).\n");
+  fprintf(stderr, "-o <file> : Write to file instead of stdout.\n");
+  fprintf(stderr, "-q : Only the summary.\n");
+  exit(2);
+}
+
+// Name of the key in the output.
+static std::string keyName(int key) {
+  switch (key) {
+    case kKeyMouse: return "click";
+    case kKeyResize: return "resize";
+    case kKeyLeft: return "left";
+    case kKeyRight: return "right";
+    case kKeyUp: return "up";
+    case kKeyDown: return "down";
+    case kKeyEscape: return "escape";
+    default:
+      if (key > ' ' && key < 127 && key != '"' && key != '\\') {
+        return std::string(1, static_cast<char>(key));
+      }
+      return std::to_string(key);
+  }
+}
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"repeat", 1, NULL, 'r'},
+    {"output", 1, NULL, 'o'},
+    {"quiet", 0, NULL, 'q'},
+    {NULL, 0, NULL, 0}
+  };
+  size_t repeat = 1;
+  std::string output;
+  bool quiet = false;
+  while (true) {
+    int c = getopt_long(argc, argv, "r:o:q", options, NULL);
+    if (c == -1) { break; }
+    switch (c) {
+      case 'r':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        repeat = atoi(optarg);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'q':
+        quiet = true;
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind + 1 != argc) { printUsageAndExit(); }
+
+  Session session;
+  std::string error;
+  if (!readSession(argv[optind], &session, &error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  FILE* out = stdout;
+  if (!output.empty()) {
+    out = fopen(output.c_str(), "w");
+    if (out == NULL) {
+      fprintf(stderr, "Error opening file: %s\n", output.c_str());
+      return 1;
+    }
+  }
+
+  // Every round on a new game, so they all start from the same board.
+  std::vector<uint64_t> fastest;
+  for (size_t round = 0; round < repeat; round++) {
+    GameView view;
+    std::vector<uint64_t> nanos;
+    if (!view.replay(session, &nanos, &error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    if (round == 0) {
+      fastest = nanos;
+    } else {
+      for (size_t k = 0; k < nanos.size(); k++) {
+        fastest[k] = std::min(fastest[k], nanos[k]);
+      }
+    }
+  }
+
+  // The events in the order of the keys which came first.
+  std::vector<int> keys;
+  std::vector<uint64_t> counts;
+  std::vector<uint64_t> totals;
+  std::vector<uint64_t> slowest;
+  uint64_t total = 0;
+  for (size_t k = 0; k < fastest.size(); k++) {
+    const SessionEvent& event = session.events[k];
+    if (!quiet) {
+      fprintf(out, "{\"event\": %zu, \"at_ms\": %.3f, \"key\": \"%s\", "
+                   "\"ns\": %llu}\n", k, event.micros / 1e3,
+              keyName(event.key).c_str(),
+              static_cast<unsigned long long>(fastest[k]));
+    }
+    size_t i = std::find(keys.begin(), keys.end(), event.key) - keys.begin();
+    if (i == keys.size()) {
+      keys.push_back(event.key);
+      counts.push_back(0);
+      totals.push_back(0);
+      slowest.push_back(0);
+    }
+    counts[i]++;
+    totals[i] += fastest[k];
+    slowest[i] = std::max(slowest[i], fastest[k]);
+    total += fastest[k];
+  }
+  fprintf(stderr, "%s: %zu events of %.1f s played in %.3f ms\n",
+          session.inputFileName.c_str(), fastest.size(),
+          session.events.empty() ? 0.0 : session.events.back().micros / 1e6,
+          total / 1e6);
+  for (size_t i = 0; i < keys.size(); i++) {
+    fprintf(stderr, "%-8s %8llu events, mean %10llu ns, max %10llu ns\n",
+            keyName(keys[i]).c_str(),
+            static_cast<unsigned long long>(counts[i]),
+            static_cast<unsigned long long>(totals[i] / counts[i]),
+            static_cast<unsigned long long>(slowest[i]));
+  }
+  if (out != stdout) { fclose(out); }
+  return 0;
+}
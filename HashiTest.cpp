@@ -2,7 +2,14 @@
 // Mail: <tomkre13@gmail.com>
 
 #include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./GameView.h"
 #include "./Hashi.h"
+#include "./Session.h"
+#include "./Stats.h"
 
 // ____________________________________________________________________________
 TEST(HashiTest, setUndoDefault) {
@@ -29,3 +36,102 @@ TEST(HashiTest, parseCommandLineArguments) {
   hashi.parseCommandLineArguments(argc, argv);
   ASSERT_EQ(15, hashi._undos);
 }
+
+// ____________________________________________________________________________
+TEST(HashiTest, parseStatsOption) {
+  Hashi hashi;
+  ASSERT_EQ("", hashi._statsFileName);
+  char* stats[3] = {
+    const_cast<char*>("./HashiMain"),
+    const_cast<char*>("--stats=/tmp/stats.json"),
+    const_cast<char*>("i018-n005-s13x08.xy")
+  };
+  hashi.parseCommandLineArguments(3, stats);
+  ASSERT_EQ("/tmp/stats.json", hashi._statsFileName);
+  stats[1] = const_cast<char*>("-S");
+  hashi.parseCommandLineArguments(3, stats);
+  ASSERT_EQ("hashi-stats.txt", hashi._statsFileName);
+}
+
+
+// ____________________________________________________________________________
+TEST(HashiTest, recordAndReplay) {
+  typedef std::pair<size_t, size_t> P;
+  const char* filename = "/tmp/HashiTest.session";
+  std::string error;
+  Hashi hashi;
+  hashi._inputFileName = "i018-n005-s13x08.xy";
+  hashi._undos = -1;
+  hashi.readInstance();
+  hashi._view.resize(80, 48);
+  ASSERT_TRUE(hashi._recorder.open(filename, hashi._inputFileName,
+                                   hashi._undos, 80, 48, &error)) << error;
+  // Two bridges from (0, 0) to (9, 0), one to (0, 7), an undo and a redo.
+  // Without a terminal there are no clicks from getmouse(), so they are
+  // handled like processUserInput() does.
+  int clicks[][2] = {{5, 5}, {50, 5}, {5, 5}, {50, 5}, {5, 5}, {5, 40}};
+  for (auto click : clicks) {
+    SessionEvent event = SessionEvent{0, kKeyMouse, true,
+                                      static_cast<uint32_t>(click[0]),
+                                      static_cast<uint32_t>(click[1]),
+                                      kButton1Clicked};
+    hashi._recorder.record(event);
+    hashi.handleEvent(event);
+  }
+  hashi.processUserInput('u');
+  hashi.processUserInput('r');
+  hashi.processUserInput('w');
+  ASSERT_EQ(2, hashi._view.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(1, hashi._view.checkBridge(P(0, 0), P(0, 7)));
+  remove(hashi._view.snapshotFileName().c_str());
+  // The s key with the name of the solution file, which processUserInput()
+  // reads from the terminal.
+  const char* solution = "/tmp/HashiTest.solution";
+  FILE* file = fopen(solution, "w");
+  ASSERT_TRUE(file != NULL);
+  fprintf(file, "0,0,9,0\n0,0,9,0\n0,0,0,7\n9,0,9,3\n0,7,12,7\n");
+  fclose(file);
+  SessionEvent load = SessionEvent{0, 's', false, 0, 0, 0, solution};
+  hashi._recorder.record(load);
+  hashi.handleEvent(load);
+  ASSERT_TRUE(hashi._recorder.close(&error)) << error;
+  ASSERT_TRUE(hashi._view.victory());
+
+  Session session;
+  ASSERT_TRUE(readSession(filename, &session, &error)) << error;
+  ASSERT_EQ(10u, session.events.size());
+  ASSERT_EQ(solution, session.events[9].text);
+  GameView replayed;
+  std::vector<uint64_t> nanos;
+  ASSERT_TRUE(replayed.replay(session, &nanos, &error)) << error;
+  ASSERT_EQ(10u, nanos.size());
+  ASSERT_EQ(0u, nanos[8]);
+  ASSERT_LT(0u, nanos[9]);
+  // The replay loaded the same solution file.
+  ASSERT_TRUE(replayed.victory());
+  ASSERT_EQ(2, replayed.checkBridge(P(0, 0), P(9, 0)));
+  ASSERT_EQ(1, replayed.checkBridge(P(9, 0), P(9, 3)));
+  ASSERT_EQ(-1, replayed.undos());
+  // Nothing was saved by the replay.
+  ASSERT_EQ(NULL, fopen(replayed.snapshotFileName().c_str(), "r"));
+  remove(solution);
+  remove(filename);
+}
+
+// ____________________________________________________________________________
+TEST(HashiTest, statsKey) {
+  Hashi hashi;
+  hashi._inputFileName = "i018-n005-s13x08.xy";
+  hashi.readInstance();
+  bool enabled = gameStats().enabled();
+  // Without --stats the p key does nothing.
+  hashi.handleEvent(SessionEvent{0, 'p', false, 0, 0, 0});
+  ASSERT_EQ(enabled, gameStats().enabled());
+  ASSERT_EQ("", hashi._view.status());
+  hashi._statsFileName = "/tmp/HashiTest-stats.txt";
+  hashi.handleEvent(SessionEvent{0, 'p', false, 0, 0, 0});
+  ASSERT_EQ(!enabled, gameStats().enabled());
+  ASSERT_EQ(enabled ? "Stats off" : "Stats on", hashi._view.status());
+  hashi.handleEvent(SessionEvent{0, 'p', false, 0, 0, 0});
+  ASSERT_EQ(enabled, gameStats().enabled());
+}
@@ -0,0 +1,116 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "./Parallel.h"
+#include "./Verifier.h"
+
+// ____________________________________________________________________________
+static void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./HashiVerifyMain [options] "
+                  "(<inputfile> <solutionfile>)...\n");
+  fprintf(stderr, "Checks every solution file against its input file.\n");
+  fprintf(stderr, "Available options:\n");
+  fprintf(stderr, "-t <integer> : Amount of threads (default: all cores).\n");
+  fprintf(stderr, "-l <file> : Also check the pairs in file, one\n");
+  fprintf(stderr, "     \"<inputfile> <solutionfile>\" per line.\n");
+  fprintf(stderr, "-q : Only print the solutions which aren't correct.\n");
+  exit(2);
+}
+
+// Adds the pairs of the list file to jobs.
+static void readList(const std::string& filename,
+                     std::vector<VerifyJob>* jobs) {
+  std::ifstream file(filename.c_str());
+  if (!file.is_open()) {
+    std::cerr << "Error opening file: " << filename << std::endl;
+    exit(2);
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') { continue; }
+    VerifyJob job;
+    size_t blank = line.find_first_of(" \t");
+    size_t next = line.find_first_not_of(" \t\r", blank);
+    if (blank == std::string::npos || next == std::string::npos) {
+      std::cerr << filename << ": malformed pair: " << line << std::endl;
+      exit(2);
+    }
+    job.instance = line.substr(0, blank);
+    job.solution = line.substr(next, line.find_last_not_of(" \t\r") + 1 -
+                                     next);
+    jobs->push_back(job);
+  }
+}
+
+// ____________________________________________________________________________
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"threads", 1, NULL, 't'},
+    {"list", 1, NULL, 'l'},
+    {"quiet", 0, NULL, 'q'},
+    {NULL, 0, NULL, 0}
+  };
+  size_t threads = hardwareThreads();
+  bool quiet = false;
+  std::vector<VerifyJob> jobs;
+  while (true) {
+    int c = getopt_long(argc, argv, "t:l:q", options, NULL);
+    if (c == -1) { break; }
+    switch (c) {
+      case 't':
+        if (atoi(optarg) < 1) { printUsageAndExit(); }
+        threads = atoi(optarg);
+        break;
+      case 'l':
+        readList(optarg, &jobs);
+        break;
+      case 'q':
+        quiet = true;
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if ((argc - optind) % 2 != 0) { printUsageAndExit(); }
+  for (int i = optind; i < argc; i += 2) {
+    VerifyJob job;
+    job.instance = argv[i];
+    job.solution = argv[i + 1];
+    jobs.push_back(job);
+  }
+  if (jobs.empty()) { printUsageAndExit(); }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Verdict> verdicts = verifyAll(jobs, threads);
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  // The verdicts in the order of the input, then the totals.
+  size_t counts[3] = {0, 0, 0};
+  size_t isles = 0;
+  for (size_t k = 0; k < jobs.size(); k++) {
+    const Verdict& verdict = verdicts[k];
+    counts[verdict.result]++;
+    isles += verdict.isles;
+    if (quiet && verdict.result == Verdict::CORRECT) { continue; }
+    std::cout << resultName(verdict.result) << " " << jobs[k].instance << " "
+              << jobs[k].solution;
+    if (!verdict.message.empty()) { std::cout << ": " << verdict.message; }
+    std::cout << "\n";
+  }
+  std::cout << "Checked " << jobs.size() << " solutions ("
+            << counts[Verdict::CORRECT] << " correct, "
+            << counts[Verdict::WRONG] << " wrong, "
+            << counts[Verdict::INVALID] << " invalid) with " << threads
+            << " threads in " << seconds << "s: " << jobs.size() / seconds
+            << " solutions/s, " << isles / seconds << " isles/s" << std::endl;
+  return counts[Verdict::CORRECT] == jobs.size() ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "./Board.h"
+#include "./HintEngine.h"
+#include "./Neighbours.h"
+
+static const Direction kDirections[] = {UP, RIGHT, DOWN, LEFT};
+
+// Returns "x,y" of isle i.
+static std::string position(const Board& board, size_t i) {
+  return std::to_string(board.getX(i)) + "," + std::to_string(board.getY(i));
+}
+
+// ____________________________________________________________________________
+std::string hintText(const Hint& hint, const Board& board) {
+  switch (hint.kind) {
+    case Hint::FORCED: {
+      size_t other = board.getStart(hint.bridge) == hint.isle ?
+                     board.getEnd(hint.bridge) : board.getStart(hint.bridge);
+      return "Hint: isle " + position(board, hint.isle) +
+             " needs another bridge to " + position(board, other);
+    }
+    case Hint::TOO_MANY:
+      return "Dead end: isle " + position(board, hint.isle) +
+             " has more bridges than its value";
+    case Hint::NO_ROOM:
+      return "Dead end: isle " + position(board, hint.isle) + " needs " +
+             std::to_string(hint.needed) +
+             " more bridges, its neighbours can take " +
+             std::to_string(hint.room);
+    case Hint::ISOLATED:
+      return "Dead end: the isles connected to " +
+             position(board, hint.isle) +
+             " are done, but cut off from the rest";
+    default:
+      return "No hint: nothing is forced right now";
+  }
+}
+
+// ____________________________________________________________________________
+HintEngine::HintEngine() {
+  _resetPending = false;
+  _stop = false;
+  _started = false;
+  _background = true;
+  _received = 0;
+  _evaluated = 0;
+  _latest = Hint{Hint::NONE, 0, 0, 0, 0};
+  _seenStamp = 0;
+}
+
+// ____________________________________________________________________________
+HintEngine::~HintEngine() { setBackground(false); }
+
+// ____________________________________________________________________________
+void HintEngine::reset(const Board& board) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Changes of the old board don't matter anymore.
+    _changes.clear();
+    _resetBoard = board;
+    _resetPending = true;
+    _started = true;
+    _received++;
+    if (!_background) { return; }
+  }
+  if (!_thread.joinable()) { _thread = std::thread(&HintEngine::run, this); }
+  _changed.notify_one();
+}
+
+// ____________________________________________________________________________
+void HintEngine::update(size_t b, int count) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_started) { return; }
+    _changes.push_back(Change{b, count});
+    _received++;
+    if (!_background) { return; }
+  }
+  _changed.notify_one();
+}
+
+// ____________________________________________________________________________
+bool HintEngine::hint(Hint* hint) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (!_background) { catchUp(&lock); }
+  *hint = _latest;
+  return _evaluated == _received;
+}
+
+// ____________________________________________________________________________
+void HintEngine::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (!_background) { catchUp(&lock); }
+  _caughtUp.wait(lock, [this]() { return _evaluated == _received; });
+}
+
+// ____________________________________________________________________________
+void HintEngine::setBackground(bool background) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _background = background;
+    _stop = !background;
+  }
+  if (background) {
+    // The thread takes over what is waiting.
+    if (_started && !_thread.joinable()) {
+      _thread = std::thread(&HintEngine::run, this);
+    }
+    _changed.notify_one();
+  } else if (_thread.joinable()) {
+    _changed.notify_one();
+    _thread.join();
+  }
+}
+
+// ____________________________________________________________________________
+void HintEngine::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _changed.wait(lock, [this]() {
+      return _stop || _resetPending || !_changes.empty();
+    });
+    if (_stop) { return; }
+    catchUp(&lock);
+  }
+}
+
+// ____________________________________________________________________________
+void HintEngine::catchUp(std::unique_lock<std::mutex>* lock) {
+  if (!_resetPending && _changes.empty()) { return; }
+  // Take everything which is waiting, the game can go on meanwhile.
+  bool reset = _resetPending;
+  Board board;
+  if (reset) {
+    board = std::move(_resetBoard);
+    _resetBoard = Board();
+    _resetPending = false;
+  }
+  std::vector<Change> changes;
+  changes.swap(_changes);
+  size_t received = _received;
+  lock->unlock();
+
+  if (reset) { start(board); }
+  for (const Change& change : changes) {
+    apply(change.bridge, change.count);
+  }
+  evaluate();
+  Hint best = bestHint();
+
+  lock->lock();
+  _latest = best;
+  _evaluated = received;
+  _caughtUp.notify_all();
+}
+
+// ____________________________________________________________________________
+void HintEngine::start(const Board& board) {
+  _board = board;
+  size_t n = _board.numIsles();
+  _counts.resize(_board.numBridges());
+  for (size_t b = 0; b < _counts.size(); b++) {
+    _counts[b] = _board.getCount(b);
+  }
+  // The bridges of the copy came without checkpoints.
+  _built.clear();
+  _dirty.assign(n, 0);
+  _dirtyIsles.clear();
+  _dead.assign(n, Hint::NONE);
+  _isolated.assign(n, 0);
+  _forced.assign(n, -1);
+  _needed.assign(n, 0);
+  _room.assign(n, 0);
+  _deadIsles.clear();
+  _forcingIsles.clear();
+  _seen.assign(n, 0);
+  _seenStamp = 0;
+  for (size_t i = 0; i < n; i++) { markDirty(i); }
+}
+
+// ____________________________________________________________________________
+void HintEngine::apply(size_t b, int count) {
+  if (b >= _counts.size() || _counts[b] == count) { return; }
+  while (_counts[b] < count) {
+    _built.push_back(std::make_pair(b, _board.addBridge(b)));
+    _counts[b]++;
+  }
+  while (_counts[b] > count) {
+    _counts[b]--;
+    if (!_built.empty() && _built.back().first == b) {
+      _board.removeBridge(b, _built.back().second);
+      _built.pop_back();
+    } else {
+      // Not the latest bridge we built (or one of the copy), so build all
+      // of them again.
+      _board.clearBridges();
+      _built.clear();
+      for (size_t r = 0; r < _counts.size(); r++) {
+        for (int k = 0; k < _counts[r]; k++) {
+          _built.push_back(std::make_pair(r, _board.addBridge(r)));
+        }
+      }
+    }
+  }
+  markAround(b);
+}
+
+// ____________________________________________________________________________
+void HintEngine::markDirty(size_t i) {
+  if (_dirty[i]) { return; }
+  _dirty[i] = 1;
+  _dirtyIsles.push_back(i);
+}
+
+// ____________________________________________________________________________
+void HintEngine::markAround(size_t b) {
+  // The isles of b have other remaining values, which changes the room
+  // of the records to their neighbours.
+  for (size_t i : {_board.getStart(b), _board.getEnd(b)}) {
+    markDirty(i);
+    for (Direction direction : kDirections) {
+      int neighbour = _board.getNeighbour(i, direction);
+      if (neighbour >= 0) { markDirty(neighbour); }
+    }
+  }
+  // The records crossing b may have been closed or opened. Such a record
+  // joins the two nearest isles in a line across b.
+  size_t s = _board.getStart(b);
+  size_t t = _board.getEnd(b);
+  bool horizontal = _board.getY(s) == _board.getY(t);
+  size_t line = horizontal ? _board.getY(s) : _board.getX(s);
+  size_t from = horizontal ? _board.getX(s) : _board.getY(s);
+  size_t to = horizontal ? _board.getX(t) : _board.getY(t);
+  for (size_t cross = from + 1; cross < to; cross++) {
+    const uint32_t* first = horizontal ? _board.columnBegin(cross) :
+                                         _board.rowBegin(cross);
+    const uint32_t* last = horizontal ? _board.columnEnd(cross) :
+                                        _board.rowEnd(cross);
+    const uint32_t* behind = std::upper_bound(first, last, line,
+                                              [&](size_t p, uint32_t i) {
+      return p < (horizontal ? _board.getY(i) : _board.getX(i));
+    });
+    if (behind == first || behind == last) { continue; }
+    markDirty(*(behind - 1));
+    markDirty(*behind);
+  }
+}
+
+// ____________________________________________________________________________
+void HintEngine::evaluate() {
+  for (size_t i : _dirtyIsles) { evaluateIsle(i); }
+  // The groups last, they only depend on the bridges.
+  _seenStamp++;
+  for (size_t i : _dirtyIsles) {
+    if (_seen[i] != _seenStamp) { evaluateGroup(i); }
+    _dirty[i] = 0;
+  }
+  _dirtyIsles.clear();
+}
+
+// ____________________________________________________________________________
+int HintEngine::room(size_t i, Direction direction, int remaining) const {
+  int b = _board.getBridge(i, direction);
+  if (b < 0) { return 0; }
+  int count = _board.getCount(b);
+  if (count == 2 || (count == 0 && _board.crossesBridge(b))) { return 0; }
+  int other = _board.getRemaining(_board.getNeighbour(i, direction));
+  return std::max(0, std::min(std::min(2 - count, remaining), other));
+}
+
+// ____________________________________________________________________________
+void HintEngine::evaluateIsle(size_t i) {
+  int remaining = _board.getRemaining(i);
+  _dead[i] = Hint::NONE;
+  _forced[i] = -1;
+  if (remaining < 0) {
+    _dead[i] = Hint::TOO_MANY;
+    _needed[i] = -remaining;
+  } else {
+    int rooms[4];
+    int total = 0;
+    for (Direction direction : kDirections) {
+      rooms[direction] = room(i, direction, remaining);
+      total += rooms[direction];
+    }
+    if (remaining > total) {
+      _dead[i] = Hint::NO_ROOM;
+      _needed[i] = remaining;
+      _room[i] = total;
+    } else {
+      // If the other records can't take all bridges, this one has to.
+      for (Direction direction : kDirections) {
+        if (remaining - (total - rooms[direction]) > 0) {
+          _forced[i] = _board.getBridge(i, direction);
+          break;
+        }
+      }
+    }
+  }
+  updateSets(i);
+}
+
+// ____________________________________________________________________________
+void HintEngine::evaluateGroup(size_t i) {
+  // Depth first search over the records with bridges.
+  _group.clear();
+  _stack.clear();
+  _stack.push_back(i);
+  _seen[i] = _seenStamp;
+  bool done = true;
+  while (!_stack.empty()) {
+    size_t isle = _stack.back();
+    _stack.pop_back();
+    _group.push_back(isle);
+    if (_board.getRemaining(isle) != 0) { done = false; }
+    for (Direction direction : kDirections) {
+      int b = _board.getBridge(isle, direction);
+      if (b < 0 || _board.getCount(b) == 0) { continue; }
+      size_t other = _board.getNeighbour(isle, direction);
+      if (_seen[other] == _seenStamp) { continue; }
+      _seen[other] = _seenStamp;
+      _stack.push_back(other);
+    }
+  }
+  char isolated = done && _group.size() < _board.numIsles();
+  for (size_t isle : _group) {
+    if (_isolated[isle] == isolated) { continue; }
+    _isolated[isle] = isolated;
+    updateSets(isle);
+  }
+}
+
+// ____________________________________________________________________________
+void HintEngine::updateSets(size_t i) {
+  if (_dead[i] != Hint::NONE || _isolated[i]) {
+    _deadIsles.insert(i);
+  } else {
+    _deadIsles.erase(i);
+  }
+  if (_forced[i] >= 0) {
+    _forcingIsles.insert(i);
+  } else {
+    _forcingIsles.erase(i);
+  }
+}
+
+// ____________________________________________________________________________
+Hint HintEngine::bestHint() const {
+  Hint hint = Hint{Hint::NONE, 0, 0, 0, 0};
+  if (!_deadIsles.empty()) {
+    hint.isle = *_deadIsles.begin();
+    hint.kind = _dead[hint.isle] != Hint::NONE ? _dead[hint.isle] :
+                                                 Hint::ISOLATED;
+    hint.needed = _needed[hint.isle];
+    hint.room = _room[hint.isle];
+  } else if (!_forcingIsles.empty()) {
+    hint.kind = Hint::FORCED;
+    hint.isle = *_forcingIsles.begin();
+    hint.bridge = _forced[hint.isle];
+  }
+  return hint;
+}
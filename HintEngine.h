@@ -0,0 +1,174 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef HINTENGINE_H_
+#define HINTENGINE_H_
+
+#include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "./Board.h"
+#include "./Neighbours.h"
+
+// What the hint engine found out about the game.
+struct Hint {
+  enum Kind {
+    // Nothing is forced and nothing is wrong yet.
+    NONE,
+    // Isle isle needs another bridge on record bridge in every solution.
+    FORCED,
+    // Isle isle has more bridges than its value.
+    TOO_MANY,
+    // Isle isle still needs needed bridges, but its neighbours can only
+    // take room more.
+    NO_ROOM,
+    // The isles connected to isle isle have all their bridges, but they
+    // aren't connected to the rest.
+    ISOLATED
+  };
+  Kind kind;
+  size_t isle;
+  size_t bridge;
+  int needed;
+  int room;
+};
+
+// Returns the text the game shows for the hint, with the positions of
+// the isles on board.
+std::string hintText(const Hint& hint, const Board& board);
+
+// Keeps the forced moves and the dead ends of a game up to date on a
+// background thread, so the game never waits for it. The engine has a copy
+// of the board which follows the changes of the game. After a change only
+// the isles whose bridges or neighbours changed are looked at again (and
+// the group of isles the changed bridge belongs to).
+class HintEngine {
+ public:
+  // Constructor, the thread starts with the first reset().
+  HintEngine();
+
+  // Stops the thread.
+  ~HintEngine();
+
+  // Starts over with a copy of board and looks at every isle.
+  void reset(const Board& board);
+
+  // Tells the engine that record b of the board now has count bridges.
+  // Ignored before the first reset().
+  void update(size_t b, int count);
+
+  // Writes the latest hint to hint. Returns false if the engine hasn't
+  // caught up with the latest change yet (the hint may be out of date
+  // then). Never waits for the engine.
+  bool hint(Hint* hint);
+
+  // Waits until the engine has caught up with all changes.
+  void wait();
+
+  // With background false the thread stops and the changes wait until
+  // hint() or wait() catches up with them on the calling thread, so the
+  // hints don't depend on how far the thread got (for a replay). True
+  // starts the thread again.
+  void setBackground(bool background);
+
+ private:
+  // A change of the game, see update().
+  struct Change {
+    size_t bridge;
+    int count;
+  };
+
+  // The loop of the thread: waits for changes and evaluates them.
+  void run();
+
+  // Evaluates the changes which are waiting. Called with lock held, it is
+  // released while evaluating.
+  void catchUp(std::unique_lock<std::mutex>* lock);
+
+  // Takes the new board of a reset() and marks every isle.
+  void start(const Board& board);
+
+  // Brings record b of our board to count bridges and marks the isles
+  // around it.
+  void apply(size_t b, int count);
+
+  // Marks isle i to be looked at again.
+  void markDirty(size_t i);
+
+  // Marks the isles of record b, their neighbours and the isles of the
+  // records which cross it.
+  void markAround(size_t b);
+
+  // Looks at all marked isles again.
+  void evaluate();
+
+  // Checks the bridges isle i still needs against the room its records
+  // leave.
+  void evaluateIsle(size_t i);
+
+  // How many more bridges the record of isle i in direction can take
+  // if i still needs remaining.
+  int room(size_t i, Direction direction, int remaining) const;
+
+  // Follows the bridges from isle i and checks whether its group is done
+  // but cut off from the rest.
+  void evaluateGroup(size_t i);
+
+  // Puts isle i into _deadIsles and _forcingIsles or takes it out.
+  void updateSets(size_t i);
+
+  // The hint for the current state: a dead end first, then a forced move.
+  Hint bestHint() const;
+
+  // Shared with the game under _mutex.
+  std::mutex _mutex;
+  std::condition_variable _changed;
+  std::condition_variable _caughtUp;
+  std::vector<Change> _changes;
+  bool _resetPending;
+  Board _resetBoard;
+  bool _stop;
+  bool _started;
+  bool _background;
+  size_t _received;
+  size_t _evaluated;
+  Hint _latest;
+  std::thread _thread;
+
+  // Only used by the thread: our board, the bridges of every record and
+  // the bridges we built with their checkpoints, so they can be removed
+  // in reverse order.
+  Board _board;
+  std::vector<int> _counts;
+  std::vector<std::pair<size_t, size_t>> _built;
+
+  // The isles to look at again.
+  std::vector<char> _dirty;
+  std::vector<size_t> _dirtyIsles;
+
+  // What every isle knows: a dead end of its own (TOO_MANY or NO_ROOM or
+  // NONE), whether its group is ISOLATED and the record it forces (-1 if
+  // none).
+  std::vector<Hint::Kind> _dead;
+  std::vector<char> _isolated;
+  std::vector<int> _forced;
+  std::vector<int> _needed;
+  std::vector<int> _room;
+
+  // The isles with a dead end and with a forced record, by index.
+  std::set<size_t> _deadIsles;
+  std::set<size_t> _forcingIsles;
+
+  // Marks and stack for evaluateGroup().
+  std::vector<size_t> _seen;
+  size_t _seenStamp;
+  std::vector<size_t> _stack;
+  std::vector<size_t> _group;
+};
+
+#endif  // HINTENGINE_H_
@@ -0,0 +1,158 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./Board.h"
+#include "./Generator.h"
+#include "./HintEngine.h"
+#include "./Puzzle.h"
+
+// Returns the hint after the engine caught up.
+static Hint currentHint(HintEngine* engine) {
+  engine->wait();
+  Hint hint;
+  EXPECT_TRUE(engine->hint(&hint));
+  return hint;
+}
+
+// ____________________________________________________________________________
+TEST(HintEngineTest, forcedAndDead) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Board board;
+  board.load(puzzle);
+  HintEngine engine;
+  // Nothing happens before the first reset.
+  engine.update(0, 1);
+  engine.wait();
+  engine.reset(board);
+  // (0, 0) can take at most two bridges to each side, but needs three.
+  Hint hint = currentHint(&engine);
+  ASSERT_EQ(Hint::FORCED, hint.kind);
+  ASSERT_EQ(board.isleAt(0, 0), static_cast<int>(hint.isle));
+  ASSERT_EQ("Hint: isle 0,0 needs another bridge to 9,0",
+            hintText(hint, board));
+
+  // Two bridges from (0, 0) down leave (0, 0) one bridge for (9, 0), which
+  // needs three.
+  int down = board.bridgeBetween(board.isleAt(0, 0), board.isleAt(0, 7));
+  engine.update(down, 1);
+  engine.update(down, 2);
+  hint = currentHint(&engine);
+  ASSERT_EQ(Hint::NO_ROOM, hint.kind);
+  ASSERT_EQ("Dead end: isle 9,0 needs 3 more bridges, its neighbours can "
+            "take 2", hintText(hint, board));
+  engine.update(down, 1);
+  ASSERT_EQ(Hint::FORCED, currentHint(&engine).kind);
+
+  // Two bridges on (9, 3), which only needs one.
+  int lower = board.bridgeBetween(board.isleAt(9, 0), board.isleAt(9, 3));
+  engine.update(lower, 2);
+  hint = currentHint(&engine);
+  ASSERT_EQ(Hint::TOO_MANY, hint.kind);
+  ASSERT_EQ("Dead end: isle 9,3 has more bridges than its value",
+            hintText(hint, board));
+  engine.update(lower, 0);
+  engine.update(down, 0);
+  ASSERT_EQ(Hint::FORCED, currentHint(&engine).kind);
+}
+
+// ____________________________________________________________________________
+TEST(HintEngineTest, isolated) {
+  // Four ones in a square: a single bridge is done, but cut off.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(2, 0, 1);
+  puzzle.addIsle(0, 2, 1);
+  puzzle.addIsle(2, 2, 1);
+  Board board;
+  board.load(puzzle);
+  HintEngine engine;
+  engine.reset(board);
+  ASSERT_EQ(Hint::NONE, currentHint(&engine).kind);
+  ASSERT_EQ("No hint: nothing is forced right now",
+            hintText(currentHint(&engine), board));
+  engine.update(board.bridgeBetween(0, 1), 1);
+  Hint hint = currentHint(&engine);
+  ASSERT_EQ(Hint::ISOLATED, hint.kind);
+  ASSERT_EQ("Dead end: the isles connected to 0,0 are done, but cut off "
+            "from the rest", hintText(hint, board));
+  engine.update(board.bridgeBetween(0, 1), 0);
+  ASSERT_EQ(Hint::NONE, currentHint(&engine).kind);
+
+  // A copy of a board with bridges starts with them.
+  board.addBridge(board.bridgeBetween(2, 3));
+  engine.reset(board);
+  ASSERT_EQ(Hint::ISOLATED, currentHint(&engine).kind);
+  ASSERT_EQ(2u, currentHint(&engine).isle);
+}
+
+// ____________________________________________________________________________
+TEST(HintEngineTest, incrementalLikeFromScratch) {
+  // Random moves on a generated puzzle: after every move the engine which
+  // only looked at the changed isles knows the same as a new one.
+  Puzzle puzzle;
+  ASSERT_TRUE(Generator(20, 15, 0.15).generate(3, &puzzle));
+  Board board;
+  board.load(puzzle);
+  HintEngine engine;
+  engine.reset(board);
+  std::mt19937 random(2018);
+  std::vector<std::pair<size_t, size_t>> built;
+  for (size_t step = 0; step < 300; step++) {
+    if (!built.empty() && random() % 3 == 0) {
+      // Take the latest bridge back like undo() does.
+      board.removeBridge(built.back().first, built.back().second);
+      engine.update(built.back().first, board.getCount(built.back().first));
+      built.pop_back();
+    } else {
+      size_t b = random() % board.numBridges();
+      if (board.getCount(b) == 2 ||
+          (board.getCount(b) == 0 && board.crossesBridge(b))) {
+        continue;
+      }
+      built.push_back(std::make_pair(b, board.addBridge(b)));
+      engine.update(b, board.getCount(b));
+    }
+    HintEngine fresh;
+    fresh.reset(board);
+    Hint expected = currentHint(&fresh);
+    Hint hint = currentHint(&engine);
+    ASSERT_EQ(expected.kind, hint.kind) << step;
+    ASSERT_EQ(expected.isle, hint.isle) << step;
+    ASSERT_EQ(expected.bridge, hint.bridge) << step;
+  }
+}
+
+// ____________________________________________________________________________
+TEST(HintEngineTest, withoutBackground) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Board board;
+  board.load(puzzle);
+  HintEngine engine;
+  engine.setBackground(false);
+  engine.reset(board);
+  // Without the thread every hint is up to date.
+  Hint hint;
+  ASSERT_TRUE(engine.hint(&hint));
+  ASSERT_EQ(Hint::FORCED, hint.kind);
+  int down = board.bridgeBetween(board.isleAt(0, 0), board.isleAt(0, 7));
+  engine.update(down, 2);
+  ASSERT_TRUE(engine.hint(&hint));
+  ASSERT_EQ(Hint::NO_ROOM, hint.kind);
+  // The thread takes over the changes which came meanwhile.
+  engine.update(down, 1);
+  engine.setBackground(true);
+  ASSERT_EQ(Hint::FORCED, currentHint(&engine).kind);
+  engine.setBackground(false);
+  engine.update(down, 2);
+  ASSERT_EQ(Hint::NO_ROOM, currentHint(&engine).kind);
+}
@@ -0,0 +1,109 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// A journal of moves which can be undone and redone in O(1). With a limited
+// capacity it's a ring buffer, so the oldest move is dropped when a new one
+// doesn't fit anymore. Unlimited it's an append-only log, which is what the
+// solver uses for its trail. Recording a move drops the moves which could
+// be redone.
+template <typename T>
+class Journal {
+ public:
+  // Capacity of a journal which keeps every move.
+  static const size_t kUnlimited = SIZE_MAX;
+
+  // Constructor, starts unlimited.
+  Journal() { reset(kUnlimited); }
+
+  // Forgets all moves and keeps at most capacity of them from now on.
+  void reset(size_t capacity) {
+    _capacity = capacity;
+    _entries.clear();
+    _first = 0;
+    _undoable = 0;
+    _redoable = 0;
+  }
+
+  // Forgets all moves.
+  void clear() { reset(_capacity); }
+
+  // Adds a move, which is the next one undo() returns.
+  void record(const T& entry) {
+    _redoable = 0;
+    if (_capacity == kUnlimited) {
+      // Moves which were undone are overwritten.
+      _entries.resize(_undoable);
+      _entries.push_back(entry);
+      _undoable++;
+      return;
+    }
+    if (_capacity == 0) { return; }
+    if (_undoable == _capacity) {
+      // Full: the oldest move goes, its slot takes the new one.
+      _first = next(_first);
+      _undoable--;
+    }
+    // The ring only grows up to the capacity once it's needed.
+    size_t k = slot(_undoable);
+    if (k == _entries.size()) {
+      _entries.push_back(entry);
+    } else {
+      _entries[k] = entry;
+    }
+    _undoable++;
+  }
+
+  // Amount of moves which can be undone and redone.
+  size_t undoable() const { return _undoable; }
+  size_t redoable() const { return _redoable; }
+
+  // Returns the latest move and steps back over it. Only if undoable() > 0.
+  const T& undo() {
+    _undoable--;
+    _redoable++;
+    return _entries[slot(_undoable)];
+  }
+
+  // Returns the move undo() stepped back over last and steps forward
+  // again. Only if redoable() > 0.
+  const T& redo() {
+    _redoable--;
+    _undoable++;
+    return _entries[slot(_undoable - 1)];
+  }
+
+  // The latest move. Only if undoable() > 0.
+  const T& back() const { return _entries[slot(_undoable - 1)]; }
+
+ private:
+  // Position of the k-th oldest move in _entries.
+  size_t slot(size_t k) const {
+    if (_capacity == kUnlimited) { return k; }
+    k += _first;
+    return k < _capacity ? k : k - _capacity;
+  }
+
+  // The position after i in the ring.
+  size_t next(size_t i) const { return i + 1 < _capacity ? i + 1 : 0; }
+
+  std::vector<T> _entries;
+  size_t _capacity;
+
+  // Position of the oldest move in the ring.
+  size_t _first;
+
+  size_t _undoable;
+  size_t _redoable;
+};
+
+template <typename T>
+const size_t Journal<T>::kUnlimited;
+
+#endif  // JOURNAL_H_
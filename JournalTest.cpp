@@ -0,0 +1,46 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include "./Journal.h"
+
+// ____________________________________________________________________________
+TEST(JournalTest, ringBuffer) {
+  Journal<int> journal;
+  journal.reset(3);
+  for (int i = 1; i <= 5; i++) { journal.record(i); }
+  // Only the latest three moves are left.
+  ASSERT_EQ(3u, journal.undoable());
+  ASSERT_EQ(5, journal.undo());
+  ASSERT_EQ(4, journal.undo());
+  ASSERT_EQ(4, journal.redo());
+  ASSERT_EQ(1u, journal.redoable());
+  // A new move drops the one which could be redone.
+  journal.record(6);
+  ASSERT_EQ(0u, journal.redoable());
+  ASSERT_EQ(6, journal.back());
+  ASSERT_EQ(6, journal.undo());
+  ASSERT_EQ(4, journal.undo());
+  ASSERT_EQ(3, journal.undo());
+  ASSERT_EQ(0u, journal.undoable());
+  ASSERT_EQ(3u, journal.redoable());
+  // Without capacity nothing is kept.
+  journal.reset(0);
+  journal.record(1);
+  ASSERT_EQ(0u, journal.undoable());
+}
+
+// ____________________________________________________________________________
+TEST(JournalTest, unlimited) {
+  Journal<int> journal;
+  for (int i = 0; i < 100000; i++) { journal.record(i); }
+  ASSERT_EQ(100000u, journal.undoable());
+  for (int i = 99999; i >= 50000; i--) { ASSERT_EQ(i, journal.undo()); }
+  journal.record(-1);
+  ASSERT_EQ(50001u, journal.undoable());
+  ASSERT_EQ(0u, journal.redoable());
+  ASSERT_EQ(-1, journal.undo());
+  ASSERT_EQ(49999, journal.undo());
+  journal.clear();
+  ASSERT_EQ(0u, journal.undoable());
+}
@@ -0,0 +1,119 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include "./MappedFile.h"
+
+// ____________________________________________________________________________
+MappedFile::MappedFile() {
+  _data = nullptr;
+  _size = 0;
+}
+
+// ____________________________________________________________________________
+MappedFile::~MappedFile() { close(); }
+
+// ____________________________________________________________________________
+bool MappedFile::open(const std::string& filename, std::string* error) {
+  close();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    *error = "Not a regular file: " + filename;
+    return false;
+  }
+  // mmap() refuses a length of 0, an empty file simply has no data.
+  if (info.st_size > 0) {
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      *error = "Error mapping file: " + filename;
+      return false;
+    }
+    // The parsers read the file once from the front to the back.
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(data);
+    _size = info.st_size;
+  }
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  return true;
+}
+
+// ____________________________________________________________________________
+void MappedFile::close() {
+  if (_data != nullptr) {
+    munmap(const_cast<char*>(_data), _size);
+  }
+  _data = nullptr;
+  _size = 0;
+}
+
+// ____________________________________________________________________________
+const char* MappedFile::begin() const { return _data; }
+
+// ____________________________________________________________________________
+const char* MappedFile::end() const { return _data + _size; }
+
+// ____________________________________________________________________________
+size_t MappedFile::size() const { return _size; }
+
+// ____________________________________________________________________________
+const char* skipBlanks(const char* pos, const char* end) {
+  while (pos < end && (*pos == ' ' || *pos == '\t')) { pos++; }
+  return pos;
+}
+
+// ____________________________________________________________________________
+const char* scanNumber(const char* pos, const char* end, size_t* value) {
+  pos = skipBlanks(pos, end);
+  const char* first = pos;
+  *value = 0;
+  while (pos < end && *pos >= '0' && *pos <= '9') {
+    // Nine digits always fit, longer numbers are no sensible coordinate.
+    if (pos - first == 9) { return nullptr; }
+    *value = *value * 10 + (*pos - '0');
+    pos++;
+  }
+  return pos == first ? nullptr : pos;
+}
+
+// ____________________________________________________________________________
+bool scanNumbers(const char* pos, const char* end, size_t* values,
+                 size_t count) {
+  for (size_t k = 0; k < count; k++) {
+    if (k > 0) {
+      if (pos == end || *pos != ',') { return false; }
+      pos++;
+    }
+    pos = scanNumber(pos, end, &values[k]);
+    if (pos == nullptr) { return false; }
+  }
+  return skipBlanks(pos, end) == end;
+}
+
+// ____________________________________________________________________________
+const char* lineEnd(const char* pos, const char* end) {
+  const char* newline = static_cast<const char*>(
+      memchr(pos, '\n', end - pos));
+  const char* last = newline == nullptr ? end : newline;
+  if (last > pos && last[-1] == '\r') { last--; }
+  return last;
+}
+
+// ____________________________________________________________________________
+const char* nextLine(const char* pos, const char* end) {
+  const char* newline = static_cast<const char*>(
+      memchr(pos, '\n', end - pos));
+  return newline == nullptr ? end : newline + 1;
+}
@@ -0,0 +1,62 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <stdio.h>
+#include <string>
+
+// A file which is mapped read-only into memory, so it can be scanned in place
+// without copying it line by line. The mapping is removed by the destructor.
+class MappedFile {
+ public:
+  // Constructor.
+  MappedFile();
+
+  // Destructor.
+  ~MappedFile();
+
+  // Maps the file. Returns false and writes a message to error if the file
+  // can't be opened or mapped. An empty file is fine, it just has no data.
+  bool open(const std::string& filename, std::string* error);
+
+  // Removes the mapping.
+  void close();
+
+  // The content of the file, begin() up to end() (exclusive).
+  const char* begin() const;
+  const char* end() const;
+  size_t size() const;
+
+ private:
+  // A mapping can't be copied.
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  const char* _data;
+  size_t _size;
+};
+
+// Helpers to scan the text of a file in place, line by line.
+
+// Skips blanks and tabs, but not the end of the line.
+const char* skipBlanks(const char* pos, const char* end);
+
+// Reads an unsigned number at pos (after blanks). Returns nullptr if there
+// is no number or it's too large, otherwise the position behind the last
+// digit.
+const char* scanNumber(const char* pos, const char* end, size_t* value);
+
+// Reads the numbers of a line like "1,2,3" into values. Returns false if the
+// line has another amount of numbers or anything else in it.
+bool scanNumbers(const char* pos, const char* end, size_t* values,
+                 size_t count);
+
+// Returns the end of the line which starts at pos (without '\r' and '\n').
+const char* lineEnd(const char* pos, const char* end);
+
+// Returns the start of the line behind the one which starts at pos.
+const char* nextLine(const char* pos, const char* end);
+
+#endif  // MAPPEDFILE_H_
@@ -0,0 +1,56 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+#include "./Neighbours.h"
+
+// ____________________________________________________________________________
+Direction directionOf(std::pair<size_t, size_t> start,
+                      std::pair<size_t, size_t> end) {
+  if (start.first == end.first) {
+    return end.second < start.second ? UP : DOWN;
+  }
+  return end.first < start.first ? LEFT : RIGHT;
+}
+
+// ____________________________________________________________________________
+Direction opposite(Direction direction) {
+  return Direction((direction + 2) % 4);
+}
+
+// ____________________________________________________________________________
+std::vector<std::array<int, 4>> findNeighbours(
+    const std::vector<std::pair<size_t, size_t>>& points) {
+  size_t n = points.size();
+  std::array<int, 4> none = {{-1, -1, -1, -1}};
+  std::vector<std::array<int, 4>> neighbours(n, none);
+
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; i++) { order[i] = i; }
+
+  // Sorted by rows, two points next to each other in the same row are
+  // horizontal neighbours. Sorted by columns we get the vertical ones.
+  for (int vertical = 0; vertical < 2; vertical++) {
+    std::sort(order.begin(), order.end(),
+              [&points, vertical](size_t a, size_t b) {
+      const std::pair<size_t, size_t>& s = points[a];
+      const std::pair<size_t, size_t>& t = points[b];
+      if (vertical) {
+        return s.first != t.first ? s.first < t.first : s.second < t.second;
+      }
+      return s.second != t.second ? s.second < t.second : s.first < t.first;
+    });
+    for (size_t k = 1; k < n; k++) {
+      const std::pair<size_t, size_t>& s = points[order[k - 1]];
+      const std::pair<size_t, size_t>& t = points[order[k]];
+      if (vertical ? s.first != t.first : s.second != t.second) { continue; }
+      neighbours[order[k - 1]][vertical ? DOWN : RIGHT] = order[k];
+      neighbours[order[k]][vertical ? UP : LEFT] = order[k - 1];
+    }
+  }
+  return neighbours;
+}
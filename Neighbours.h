@@ -0,0 +1,30 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef NEIGHBOURS_H_
+#define NEIGHBOURS_H_
+
+#include <stdio.h>
+#include <array>
+#include <utility>
+#include <vector>
+
+// The four directions an isle can have a neighbour in.
+enum Direction { UP = 0, RIGHT = 1, DOWN = 2, LEFT = 3 };
+
+// Returns the direction from start to end, which have to be in the same row
+// or column.
+Direction directionOf(std::pair<size_t, size_t> start,
+                      std::pair<size_t, size_t> end);
+
+// Returns the opposite direction.
+Direction opposite(Direction direction);
+
+// Finds the nearest point up, right, down and left of every point with a
+// sorted sweep over the rows and the columns. Only these can be connected
+// by a bridge. The result holds the indices of the neighbours (in the order
+// of Direction) or -1 if there is none.
+std::vector<std::array<int, 4>> findNeighbours(
+    const std::vector<std::pair<size_t, size_t>>& points);
+
+#endif  // NEIGHBOURS_H_
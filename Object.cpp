@@ -2,49 +2,64 @@
 // Mail: <tomkre13@gmail.com>.
 
 #include "./Object.h"
-#include <ncurses.h>
 #include <stdio.h>
 #include <utility>
-#include <vector>
-#include <iostream>
+#include "./Board.h"
 
 // ____________________________________________________________________________
-void Isle::new_isle(std::vector<int> set) {
-  _coord = std::pair<size_t, size_t>(set.at(0), set.at(1));
-  _value = set.at(2);
+Isle::Isle(const Board* board, size_t index) {
+  _board = board;
+  _index = index;
 }
 
 // ____________________________________________________________________________
-size_t Isle::getX() { return _coord.first; }
+size_t Isle::getX() const { return _board->getX(_index); }
 
 // ____________________________________________________________________________
-size_t Isle::getY() { return _coord.second; }
+size_t Isle::getY() const { return _board->getY(_index); }
 
 // ____________________________________________________________________________
-int Isle::getValue() { return _value; }
+int Isle::getValue() const { return _board->getRemaining(_index); }
 
 // ____________________________________________________________________________
-void Isle::changeValue(bool plus) {
-  if (!plus) {
-    _value = _value - 1;
-  } else { _value = _value + 1; }
+int Isle::getRequired() const { return _board->getRequired(_index); }
+
+// ____________________________________________________________________________
+bool Isle::isValid() const { return getValue() > 0; }
+
+// ____________________________________________________________________________
+int Isle::getNeighbour(Direction direction) const {
+  return _board->getNeighbour(_index, direction);
+}
+
+// ____________________________________________________________________________
+int Isle::getBridge(Direction direction) const {
+  return _board->getBridge(_index, direction);
+}
+
+// ____________________________________________________________________________
+size_t Isle::getIndex() const { return _index; }
+
+// ____________________________________________________________________________
+Bridge::Bridge(const Board* board, size_t index) {
+  _board = board;
+  _index = index;
 }
 
 // ____________________________________________________________________________
-bool Isle::isValid() {
-  if (_value > 0) {
-    return true;
-  } else { return false; }
+std::pair<size_t, size_t> Bridge::getStart() const {
+  size_t i = _board->getStart(_index);
+  return std::pair<size_t, size_t>(_board->getX(i), _board->getY(i));
 }
 
 // ____________________________________________________________________________
-void Bridge::new_bridge(std::vector<int> bridge) {
-  _startC = std::pair<size_t, size_t>(bridge.at(0), bridge.at(1));
-  _endC = std::pair<size_t, size_t>(bridge.at(2), bridge.at(3));
+std::pair<size_t, size_t> Bridge::getEnd() const {
+  size_t i = _board->getEnd(_index);
+  return std::pair<size_t, size_t>(_board->getX(i), _board->getY(i));
 }
 
 // ____________________________________________________________________________
-std::pair<size_t, size_t> Bridge::getStart() { return _startC; }
+int Bridge::getCount() const { return _board->getCount(_index); }
 
 // ____________________________________________________________________________
-std::pair<size_t, size_t> Bridge::getEnd() { return _endC; }
+size_t Bridge::getIndex() const { return _index; }
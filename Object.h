@@ -6,60 +6,65 @@
 
 #include <stdio.h>
 #include <utility>
-#include <vector>
+#include "./Neighbours.h"
 
-class Object {
- public:
-  virtual ~Object() {}
-
- protected:
-  std::pair<size_t, size_t> _coord;
-};
+class Board;
 
-class Isle : public Object {
+// A view on one isle of a Board. It doesn't own anything, so it can be
+// copied freely, but it's only valid as long as the board is loaded.
+class Isle {
  public:
-  virtual ~Isle() {}
-
-  // Adds a new  isle to the class.
-  void new_isle(std::vector<int> set);
+  Isle(const Board* board, size_t index);
 
   // Returns the X coordinate.
-  size_t getX();
+  size_t getX() const;
 
   // Returns the Y coordinate.
-  size_t getY();
+  size_t getY() const;
 
-  // Returns the value of the isle.
-  int getValue();
+  // Returns how many bridges the isle still needs (negative if it has too
+  // many).
+  int getValue() const;
 
-  // Counts the value up or down.
-  // plus = +; !plus = -.
-  void changeValue(bool plus);
+  // Returns how many bridges the isle needs in total.
+  int getRequired() const;
 
   // Checks whether value is over zero.
-  bool isValid();
+  bool isValid() const;
+
+  // Returns the nearest isle in the given direction or -1.
+  int getNeighbour(Direction direction) const;
 
- protected:
-  int _value;
+  // Returns the bridge record to that neighbour or -1.
+  int getBridge(Direction direction) const;
+
+  // Returns the position of the isle in the list of all isles.
+  size_t getIndex() const;
+
+ private:
+  const Board* _board;
+  size_t _index;
 };
 
-class Bridge : public Object {
+// A view on one bridge record of a Board, see Isle.
+class Bridge {
  public:
-  virtual ~Bridge() {}
-
-  // Adds a new bridge to the class.
-  void new_bridge(std::vector<int> bridge);
+  Bridge(const Board* board, size_t index);
 
   // Returns the start coordinates of the bridge.
-  std::pair<size_t, size_t> getStart();
+  std::pair<size_t, size_t> getStart() const;
 
   // Returns the end coordinates of the bridge.
-  std::pair<size_t, size_t> getEnd();
- protected:
-  // Coordinates of the start isle.
-  std::pair<size_t, size_t> _startC;
+  std::pair<size_t, size_t> getEnd() const;
+
+  // Returns how many bridges connect the two isles (0, 1 or 2).
+  int getCount() const;
+
+  // Returns the position of the record in the list of all records.
+  size_t getIndex() const;
 
-  // Coordinates of the end isle.
-  std::pair<size_t, size_t> _endC;
+ private:
+  const Board* _board;
+  size_t _index;
 };
 #endif  // OBJECT_H_
@@ -0,0 +1,37 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "./Parallel.h"
+
+// ____________________________________________________________________________
+size_t hardwareThreads() {
+  // hardware_concurrency() may not know it and returns 0 then.
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// ____________________________________________________________________________
+void parallelFor(size_t jobs, size_t threads,
+                 const std::function<void(size_t job, size_t worker)>& work) {
+  threads = std::max<size_t>(1, std::min(threads, jobs));
+  std::atomic<size_t> next(0);
+  auto worker = [&](size_t number) {
+    for (size_t job = next++; job < jobs; job = next++) { work(job, number); }
+  };
+  if (threads == 1) {
+    // No need for another thread.
+    worker(0);
+    return;
+  }
+  std::vector<std::thread> pool;
+  for (size_t k = 1; k < threads; k++) {
+    pool.push_back(std::thread(worker, k));
+  }
+  worker(0);
+  for (auto& thread : pool) { thread.join(); }
+}
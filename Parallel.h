@@ -0,0 +1,21 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <stdio.h>
+#include <functional>
+
+// Returns the amount of cores (at least 1).
+size_t hardwareThreads();
+
+// Runs work(job, worker) for every job in 0 up to jobs - 1 on a pool of
+// threads. Every worker takes the next job as soon as it is done with its
+// last one, so long jobs don't hold up the others. worker is the number of
+// the thread (0 up to threads - 1), e.g. for per-thread results. Returns
+// when all jobs are done.
+void parallelFor(size_t jobs, size_t threads,
+                 const std::function<void(size_t job, size_t worker)>& work);
+
+#endif  // PARALLEL_H_
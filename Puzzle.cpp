@@ -0,0 +1,250 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./MappedFile.h"
+#include "./Puzzle.h"
+#include "./Snapshot.h"
+
+// ____________________________________________________________________________
+Puzzle::Puzzle() {
+  _width = 0;
+  _height = 0;
+}
+
+// ____________________________________________________________________________
+bool Puzzle::load(const std::string& filename, std::string* error) {
+  _isles.clear();
+  _width = 0;
+  _height = 0;
+
+  size_t dot = filename.find_last_of('.');
+  std::string ending = dot == std::string::npos ? "" : filename.substr(dot);
+  if (ending != ".xy" && ending != ".plain" && ending != ".hashi") {
+    *error = "Unknown file type: " + filename;
+    return false;
+  }
+
+  MappedFile file;
+  if (!file.open(filename, error)) { return false; }
+  bool ok;
+  if (ending == ".hashi") {
+    // Only the isles, the bridges are for Board::loadSnapshot().
+    const uint8_t* bridges;
+    size_t records;
+    ok = readSnapshot(file.begin(), file.end(), this, &bridges, &records,
+                      error);
+  } else if (ending == ".xy") {
+    ok = loadXY(file.begin(), file.end(), error);
+  } else {
+    ok = loadPlain(file.begin(), file.end(), error);
+  }
+  if (!ok) {
+    *error = filename + ":" + *error;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Puzzle::parse(const char* begin, const char* end, bool plain,
+                   std::string* error) {
+  _isles.clear();
+  _width = 0;
+  _height = 0;
+  return plain ? loadPlain(begin, end, error) : loadXY(begin, end, error);
+}
+
+// ____________________________________________________________________________
+void Puzzle::readHeader(const char* pos, const char* end) {
+  // The first comment is the header with the size: "# 7:7 (xy)". Any other
+  // comment doesn't match and is ignored.
+  size_t width, height;
+  pos = skipBlanks(pos + 1, end);
+  pos = scanNumber(pos, end, &width);
+  if (pos == nullptr || pos == end || *pos != ':') { return; }
+  if (scanNumber(pos + 1, end, &height) == nullptr) { return; }
+  _width = std::max(_width, width);
+  _height = std::max(_height, height);
+}
+
+// ____________________________________________________________________________
+bool Puzzle::malformed(const char* line, const char* end, size_t lineNumber,
+                       const char* what, std::string* error) {
+  *error = std::to_string(lineNumber) + ": " + what + ": " +
+           std::string(line, lineEnd(line, end));
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Puzzle::loadXY(const char* begin, const char* end, std::string* error) {
+  // Every line but the header holds one isle, so this is enough room.
+  size_t lines = std::count(begin, end, '\n') + 1;
+  _isles.reserve(lines);
+  // Where every isle came from, for a message about a duplicate.
+  std::vector<const char*> isleLines;
+  std::vector<size_t> isleLineNumbers;
+  isleLines.reserve(lines);
+  isleLineNumbers.reserve(lines);
+  size_t lineNumber = 0;
+  for (const char* line = begin; line < end; line = nextLine(line, end)) {
+    lineNumber++;
+    const char* last = lineEnd(line, end);
+    const char* pos = skipBlanks(line, last);
+    if (pos == last) { continue; }
+    if (*pos == '#') {
+      readHeader(pos, last);
+      continue;
+    }
+    // Every line is: x, y, value.
+    size_t values[3];
+    if (!scanNumbers(pos, last, values, 3) || values[2] < 1 || values[2] > 8) {
+      return malformed(line, end, lineNumber, "malformed isle", error);
+    }
+    addIsle(values[0], values[1], values[2]);
+    isleLines.push_back(line);
+    isleLineNumbers.push_back(lineNumber);
+  }
+
+  // Two isles at the same position would be one isle on the board. Sorted
+  // by position (and by line for the same one) the duplicates are next to
+  // each other, the first line with an isle already seen is reported.
+  std::vector<size_t> order(_isles.size());
+  for (size_t i = 0; i < order.size(); i++) { order[i] = i; }
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    const PuzzleIsle& s = _isles[a];
+    const PuzzleIsle& t = _isles[b];
+    if (s.y != t.y) { return s.y < t.y; }
+    return s.x != t.x ? s.x < t.x : a < b;
+  });
+  size_t duplicate = _isles.size();
+  for (size_t k = 1; k < order.size(); k++) {
+    const PuzzleIsle& s = _isles[order[k - 1]];
+    const PuzzleIsle& t = _isles[order[k]];
+    if (s.x == t.x && s.y == t.y) {
+      duplicate = std::min(duplicate, order[k]);
+    }
+  }
+  if (duplicate < _isles.size()) {
+    return malformed(isleLines[duplicate], end, isleLineNumbers[duplicate],
+                     "duplicate isle", error);
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Puzzle::loadPlain(const char* begin, const char* end,
+                       std::string* error) {
+  size_t lineNumber = 0;
+  size_t row = 0;
+  for (const char* line = begin; line < end; line = nextLine(line, end)) {
+    lineNumber++;
+    const char* last = lineEnd(line, end);
+    if (line < last && *line == '#') {
+      readHeader(line, last);
+      continue;
+    }
+    // Every sign which isn't a whitespace is an isle.
+    for (const char* pos = line; pos < last; pos++) {
+      if (*pos == ' ') { continue; }
+      if (*pos < '1' || *pos > '8') {
+        return malformed(line, end, lineNumber, "malformed row", error);
+      }
+      addIsle(pos - line, row, *pos - '0');
+    }
+    row++;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Puzzle::write(const std::string& filename, bool plain,
+                   std::string* error) const {
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == NULL) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  fprintf(file, "# %zu:%zu (%s)\n", _width, _height, plain ? "plain" : "xy");
+  if (plain) {
+    // One row after the other, a digit for every isle and blanks in between.
+    std::string rows(_width * _height, ' ');
+    for (const PuzzleIsle& isle : _isles) {
+      rows[isle.y * _width + isle.x] = '0' + isle.value;
+    }
+    for (size_t y = 0; y < _height; y++) {
+      fwrite(rows.data() + y * _width, 1, _width, file);
+      fputc('\n', file);
+    }
+  } else {
+    for (const PuzzleIsle& isle : _isles) {
+      fprintf(file, "%zu,%zu,%d\n", isle.x, isle.y, isle.value);
+    }
+  }
+  bool written = !ferror(file);
+  if (fclose(file) != 0 || !written) {
+    *error = "Error writing file: " + filename;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool writeSolutionFile(const std::string& filename,
+                       const std::vector<SolutionRecord>& records,
+                       std::string* error) {
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == NULL) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  fprintf(file, "# (xy.solution)\n# x1,y1,x2,y2\n");
+  for (const SolutionRecord& record : records) {
+    for (int k = 0; k < record.count; k++) {
+      fprintf(file, "%zu,%zu,%zu,%zu\n", record.x1, record.y1, record.x2,
+              record.y2);
+    }
+  }
+  bool written = !ferror(file);
+  if (fclose(file) != 0 || !written) {
+    *error = "Error writing file: " + filename;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void Puzzle::addIsle(size_t x, size_t y, int value) {
+  PuzzleIsle isle;
+  isle.x = x;
+  isle.y = y;
+  isle.value = value;
+  _isles.push_back(isle);
+  // The header is optional, so make sure every isle fits on the board.
+  _width = std::max(_width, x + 1);
+  _height = std::max(_height, y + 1);
+}
+
+// ____________________________________________________________________________
+void Puzzle::setValue(size_t i, int value) { _isles[i].value = value; }
+
+// ____________________________________________________________________________
+void Puzzle::setSize(size_t width, size_t height) {
+  _width = std::max(_width, width);
+  _height = std::max(_height, height);
+}
+
+// ____________________________________________________________________________
+size_t Puzzle::numIsles() const { return _isles.size(); }
+
+// ____________________________________________________________________________
+const PuzzleIsle& Puzzle::getIsle(size_t i) const { return _isles[i]; }
+
+// ____________________________________________________________________________
+size_t Puzzle::getWidth() const { return _width; }
+
+// ____________________________________________________________________________
+size_t Puzzle::getHeight() const { return _height; }
@@ -0,0 +1,100 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef PUZZLE_H_
+#define PUZZLE_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// An isle of a puzzle instance in grid coordinates.
+struct PuzzleIsle {
+  size_t x;
+  size_t y;
+  int value;
+};
+
+// A Hashi instance as it is given by a *.xy or *.plain file. It only knows
+// where the isles are and how many bridges they need, there is no ncurses
+// involved, so it can be used by headless tools like the solver.
+class Puzzle {
+ public:
+  // Constructor.
+  Puzzle();
+
+  // Reads the instance from filename (*.xy, *.plain or *.hashi, see
+  // Snapshot.h). Returns false and writes a message to error if something
+  // went wrong.
+  // The file is mapped into memory and scanned in place, malformed lines are
+  // reported with their line number.
+  bool load(const std::string& filename, std::string* error);
+
+  // Reads the instance from the text begin up to end, in the *.plain format
+  // if plain is true and in the *.xy format otherwise.
+  bool parse(const char* begin, const char* end, bool plain,
+             std::string* error);
+
+  // Writes the instance to filename in the *.plain format if plain is true
+  // and in the *.xy format otherwise, with the size in the header. Returns
+  // false and writes a message to error if the file can't be written.
+  bool write(const std::string& filename, bool plain,
+             std::string* error) const;
+
+  // Adds an isle at grid position (x, y).
+  void addIsle(size_t x, size_t y, int value);
+
+  // Changes the amount of bridges isle i needs.
+  void setValue(size_t i, int value);
+
+  // Makes the board at least width x height, even where there are no isles.
+  void setSize(size_t width, size_t height);
+
+  // Returns the amount of isles.
+  size_t numIsles() const;
+
+  // Returns the isle with index i.
+  const PuzzleIsle& getIsle(size_t i) const;
+
+  // Width and height of the board (taken from the header or the isles).
+  size_t getWidth() const;
+  size_t getHeight() const;
+
+ private:
+  // Readers for the two file formats.
+  bool loadXY(const char* begin, const char* end, std::string* error);
+  bool loadPlain(const char* begin, const char* end, std::string* error);
+
+  // Takes the size of the board from a header comment like "# 7:7 (xy)".
+  void readHeader(const char* pos, const char* end);
+
+  // Writes "line: what: <the line>" to error and returns false.
+  static bool malformed(const char* line, const char* end, size_t lineNumber,
+                        const char* what, std::string* error);
+
+  // All isles of the instance.
+  std::vector<PuzzleIsle> _isles;
+
+  // Size of the board.
+  size_t _width;
+  size_t _height;
+};
+
+// A bridge record of a solution: count bridges from (x1, y1) to (x2, y2).
+struct SolutionRecord {
+  size_t x1;
+  size_t y1;
+  size_t x2;
+  size_t y2;
+  int count;
+};
+
+// Writes the records as a *.solution file, one line x1,y1,x2,y2 per
+// bridge. Board, Solver and FixedBoard all write their solutions with it.
+// Returns false and writes a message to error if the file can't be
+// written.
+bool writeSolutionFile(const std::string& filename,
+                       const std::vector<SolutionRecord>& records,
+                       std::string* error);
+
+#endif  // PUZZLE_H_
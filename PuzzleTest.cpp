@@ -0,0 +1,78 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include "./Puzzle.h"
+
+// ____________________________________________________________________________
+TEST(PuzzleTest, loadPlainAndXY) {
+  Puzzle xy;
+  Puzzle plain;
+  std::string error;
+  ASSERT_TRUE(xy.load("i018-n005-s13x08.xy", &error));
+  ASSERT_TRUE(plain.load("i018-n005-s13x08.plain", &error));
+  ASSERT_EQ(13u, xy.getWidth());
+  ASSERT_EQ(8u, xy.getHeight());
+  ASSERT_EQ(xy.numIsles(), plain.numIsles());
+  ASSERT_FALSE(xy.load("does-not-exist.xy", &error));
+}
+
+// ____________________________________________________________________________
+TEST(PuzzleTest, loadReportsMalformedLine) {
+  const char* text = "# 5:5 (xy)\n0,0,2\n\n3,x,1\n";
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_FALSE(puzzle.parse(text, text + strlen(text), false, &error));
+  ASSERT_EQ("4: malformed isle: 3,x,1", error);
+  const char* plain = "# 3:2 (plain)\n2 2\r\n1 9\n";
+  ASSERT_FALSE(puzzle.parse(plain, plain + strlen(plain), true, &error));
+  ASSERT_EQ("3: malformed row: 1 9", error);
+  // Too large numbers, missing fields and trailing garbage are errors, not
+  // exceptions.
+  const char* bad[] = { "99999999999,0,1\n", "0,0\n", "0,0,1,\n", "0,0,9\n" };
+  for (const char* line : bad) {
+    ASSERT_FALSE(puzzle.parse(line, line + strlen(line), false, &error));
+    ASSERT_EQ(0u, error.find("1: malformed isle: ")) << line;
+  }
+  const char* good = "# 4:3 (xy)\r\n 1, 2, 3 \r\n3,0,1";
+  ASSERT_TRUE(puzzle.parse(good, good + strlen(good), false, &error));
+  ASSERT_EQ(2u, puzzle.numIsles());
+  ASSERT_EQ(4u, puzzle.getWidth());
+  ASSERT_EQ(3u, puzzle.getIsle(0).value);
+}
+
+// ____________________________________________________________________________
+TEST(PuzzleTest, loadHugeInstance) {
+  // Two million isles in a *.xy file, HashiBench measures how long it takes.
+  const char* filename = "/tmp/PuzzleTest-huge.xy";
+  FILE* file = fopen(filename, "w");
+  ASSERT_TRUE(file != NULL);
+  fprintf(file, "# 2000:2000 (xy)\n");
+  for (size_t y = 0; y < 2000; y += 2) {
+    for (size_t x = 0; x < 2000; x++) { fprintf(file, "%zu,%zu,2\n", x, y); }
+  }
+  fclose(file);
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load(filename, &error)) << error;
+  unlink(filename);
+  ASSERT_EQ(2000000u, puzzle.numIsles());
+  ASSERT_EQ(2000u, puzzle.getWidth());
+  ASSERT_EQ(2000u, puzzle.getHeight());
+  ASSERT_EQ(1999u, puzzle.getIsle(1999999).x);
+  ASSERT_EQ(1998u, puzzle.getIsle(1999999).y);
+}
+
+// ____________________________________________________________________________
+TEST(PuzzleTest, loadReportsDuplicateIsle) {
+  // The first line with a position which was already there is reported.
+  const char* text = "# 5:5 (xy)\n0,0,2\n3,1,1\n1,1,1\n 3, 1, 2\n0,0,1\n";
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_FALSE(puzzle.parse(text, text + strlen(text), false, &error));
+  ASSERT_EQ("5: duplicate isle:  3, 1, 2", error);
+}
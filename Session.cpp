@@ -0,0 +1,159 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "./MappedFile.h"
+#include "./Session.h"
+#include "./Snapshot.h"
+
+const char kSessionMagic[8] = {'H', 'A', 'S', 'H', 'I', 'S', 'E', 'S'};
+
+// ____________________________________________________________________________
+SessionRecorder::SessionRecorder() {
+  _file = NULL;
+  _lastMicros = 0;
+}
+
+// ____________________________________________________________________________
+SessionRecorder::~SessionRecorder() {
+  std::string error;
+  close(&error);
+}
+
+// ____________________________________________________________________________
+bool SessionRecorder::open(const std::string& filename,
+                           const std::string& inputFileName, int undos,
+                           uint32_t width, uint32_t height,
+                           std::string* error) {
+  if (!close(error)) { return false; }
+  _file = fopen(filename.c_str(), "wb");
+  if (_file == NULL) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  _filename = filename;
+  std::string header(kSessionMagic, sizeof(kSessionMagic));
+  putVarint(kSessionVersion, &header);
+  putVarint(undos < 0 ? 0 : undos + 1, &header);
+  putVarint(width, &header);
+  putVarint(height, &header);
+  putVarint(inputFileName.size(), &header);
+  header += inputFileName;
+  fwrite(header.data(), 1, header.size(), _file);
+  fflush(_file);
+  _start = std::chrono::steady_clock::now();
+  _lastMicros = 0;
+  return true;
+}
+
+// ____________________________________________________________________________
+void SessionRecorder::record(SessionEvent event) {
+  if (_file == NULL) { return; }
+  event.micros = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - _start).count();
+  _buffer.clear();
+  putVarint(event.micros - _lastMicros, &_buffer);
+  bool hasText = !event.text.empty();
+  putVarint(static_cast<uint64_t>(event.key) << 2 | hasText << 1 |
+            event.hasPosition, &_buffer);
+  if (event.hasPosition) {
+    putVarint(event.x, &_buffer);
+    putVarint(event.y, &_buffer);
+    putVarint(event.buttons, &_buffer);
+  }
+  if (hasText) {
+    putVarint(event.text.size(), &_buffer);
+    _buffer += event.text;
+  }
+  _lastMicros = event.micros;
+  fwrite(_buffer.data(), 1, _buffer.size(), _file);
+  fflush(_file);
+}
+
+// ____________________________________________________________________________
+bool SessionRecorder::close(std::string* error) {
+  if (_file == NULL) { return true; }
+  bool written = !ferror(_file);
+  if (fclose(_file) != 0 || !written) {
+    *error = "Error writing file: " + _filename;
+    written = false;
+  }
+  _file = NULL;
+  return written;
+}
+
+// ____________________________________________________________________________
+bool readSession(const std::string& filename, Session* session,
+                 std::string* error) {
+  MappedFile file;
+  if (!file.open(filename, error)) { return false; }
+  const char* begin = file.begin();
+  const char* end = file.end();
+  if (file.size() < sizeof(kSessionMagic) ||
+      memcmp(begin, kSessionMagic, sizeof(kSessionMagic)) != 0) {
+    *error = filename + ": not a session";
+    return false;
+  }
+  const char* pos = begin + sizeof(kSessionMagic);
+  uint64_t version, undos, width, height, length;
+  pos = getVarint(pos, end, &version);
+  if (pos != nullptr && version != kSessionVersion) {
+    *error = filename + ": unsupported version " + std::to_string(version);
+    return false;
+  }
+  if (pos != nullptr) { pos = getVarint(pos, end, &undos); }
+  if (pos != nullptr) { pos = getVarint(pos, end, &width); }
+  if (pos != nullptr) { pos = getVarint(pos, end, &height); }
+  if (pos != nullptr) { pos = getVarint(pos, end, &length); }
+  if (pos == nullptr || length > static_cast<uint64_t>(end - pos)) {
+    *error = filename + ": session header is cut off";
+    return false;
+  }
+  session->inputFileName.assign(pos, length);
+  session->undos = static_cast<int>(undos) - 1;
+  session->width = width;
+  session->height = height;
+  session->events.clear();
+  pos += length;
+
+  uint64_t micros = 0;
+  while (pos < end) {
+    const char* start = pos;
+    uint64_t delta, packed, x = 0, y = 0, buttons = 0;
+    uint64_t textLength = 0;
+    pos = getVarint(pos, end, &delta);
+    if (pos != nullptr) { pos = getVarint(pos, end, &packed); }
+    if (pos != nullptr && (packed & 1)) {
+      pos = getVarint(pos, end, &x);
+      if (pos != nullptr) { pos = getVarint(pos, end, &y); }
+      if (pos != nullptr) { pos = getVarint(pos, end, &buttons); }
+    }
+    if (pos != nullptr && (packed & 2)) {
+      pos = getVarint(pos, end, &textLength);
+      if (pos != nullptr && textLength > static_cast<uint64_t>(end - pos)) {
+        pos = nullptr;
+      }
+    }
+    if (pos == nullptr) {
+      *error = filename + ": malformed event at byte " +
+               std::to_string(start - begin);
+      return false;
+    }
+    micros += delta;
+    SessionEvent event;
+    event.micros = micros;
+    event.key = static_cast<int>(packed >> 2);
+    event.hasPosition = packed & 1;
+    event.x = x;
+    event.y = y;
+    event.buttons = buttons;
+    event.text.assign(pos, textLength);
+    pos += textLength;
+    session->events.push_back(event);
+  }
+  return true;
+}
@@ -0,0 +1,109 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef SESSION_H_
+#define SESSION_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// The keys of ncurses the game knows besides the characters, with the same
+// values, so the game and the replay don't need ncurses for them. Hashi.cpp
+// checks that they match.
+const int kKeyEscape = 27;
+const int kKeyDown = 0402;
+const int kKeyUp = 0403;
+const int kKeyLeft = 0404;
+const int kKeyRight = 0405;
+const int kKeyMouse = 0631;
+const int kKeyResize = 0632;
+// BUTTON1_CLICKED in the buttons of a click.
+const uint32_t kButton1Clicked = 04;
+
+// One input of the game as it came from getch(). For a click x and y are
+// the screen position and buttons the bstate of the MEVENT, for a resize
+// they are the new size of the screen. The keys are the ones of ncurses,
+// see above.
+struct SessionEvent {
+  // Microseconds since the recording started.
+  uint64_t micros;
+  int key;
+  bool hasPosition;
+  uint32_t x;
+  uint32_t y;
+  uint32_t buttons;
+  // What was typed in on the terminal after the key, like the name of the
+  // solution file for the s key. Empty for all other keys.
+  std::string text;
+};
+
+// A recorded game: what was played with which settings and every input.
+struct Session {
+  std::string inputFileName;
+  int undos;
+  uint32_t width;
+  uint32_t height;
+  std::vector<SessionEvent> events;
+};
+
+// The *.session format, all numbers are varints (see Snapshot.h):
+//
+//   header   "HASHISES", the version, undos + 1 (0 for unlimited), width
+//            and height of the screen, the length of the name of the input
+//            file and the name.
+//   events   Per event the microseconds since the event before and
+//            (key << 2 | hasText << 1 | hasPosition), then x, y and
+//            buttons if it has a position and the length of the text and
+//            the text if it has one.
+//
+// A click takes about ten bytes, a key four.
+extern const char kSessionMagic[8];
+const uint64_t kSessionVersion = 2;
+
+// Writes the inputs of a game to a file while it's played. Every event is
+// flushed right away, the game may end by exit() or a crash.
+class SessionRecorder {
+ public:
+  // Constructor, nothing is recorded.
+  SessionRecorder();
+
+  // Destructor, closes the file.
+  ~SessionRecorder();
+
+  // Starts a new file with the settings of the game, the clock starts now.
+  // Returns false and writes a message to error if it can't be written.
+  bool open(const std::string& filename, const std::string& inputFileName,
+            int undos, uint32_t width, uint32_t height, std::string* error);
+
+  // True between open() and close().
+  bool isOpen() const { return _file != NULL; }
+
+  // Appends the event, its micros are set to the time since open().
+  void record(SessionEvent event);
+
+  // Closes the file. Returns false and writes a message to error if
+  // something couldn't be written.
+  bool close(std::string* error);
+
+ private:
+  // A recorder can't be copied.
+  SessionRecorder(const SessionRecorder&);
+  SessionRecorder& operator=(const SessionRecorder&);
+
+  FILE* _file;
+  std::string _filename;
+  std::chrono::steady_clock::time_point _start;
+  uint64_t _lastMicros;
+  // The bytes of one event, kept to save the allocation.
+  std::string _buffer;
+};
+
+// Reads a session file into session. Returns false and writes a message to
+// error if it can't be read or isn't a valid session.
+bool readSession(const std::string& filename, Session* session,
+                 std::string* error);
+
+#endif  // SESSION_H_
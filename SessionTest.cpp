@@ -0,0 +1,88 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include "./Session.h"
+
+// ____________________________________________________________________________
+TEST(SessionTest, recordAndRead) {
+  const char* filename = "/tmp/SessionTest.session";
+  std::string error;
+  {
+    SessionRecorder recorder;
+    ASSERT_FALSE(recorder.isOpen());
+    ASSERT_TRUE(recorder.open(filename, "i018-n005-s13x08.xy", -1, 80, 24,
+                              &error)) << error;
+    ASSERT_TRUE(recorder.isOpen());
+    recorder.record(SessionEvent{0, 'u', false, 0, 0, 0});
+    recorder.record(SessionEvent{0, 409, true, 50, 5, 4});
+    recorder.record(SessionEvent{0, 410, true, 300, 100, 0});
+    recorder.record(SessionEvent{0, 's', false, 0, 0, 0, "i018.solution"});
+    ASSERT_TRUE(recorder.close(&error)) << error;
+    ASSERT_FALSE(recorder.isOpen());
+  }
+  Session session;
+  ASSERT_TRUE(readSession(filename, &session, &error)) << error;
+  ASSERT_EQ("i018-n005-s13x08.xy", session.inputFileName);
+  ASSERT_EQ(-1, session.undos);
+  ASSERT_EQ(80u, session.width);
+  ASSERT_EQ(24u, session.height);
+  ASSERT_EQ(4u, session.events.size());
+  ASSERT_EQ('u', session.events[0].key);
+  ASSERT_FALSE(session.events[0].hasPosition);
+  ASSERT_EQ(409, session.events[1].key);
+  ASSERT_TRUE(session.events[1].hasPosition);
+  ASSERT_EQ(50u, session.events[1].x);
+  ASSERT_EQ(5u, session.events[1].y);
+  ASSERT_EQ(4u, session.events[1].buttons);
+  ASSERT_EQ(300u, session.events[2].x);
+  ASSERT_LE(session.events[1].micros, session.events[2].micros);
+  ASSERT_EQ("", session.events[2].text);
+  ASSERT_EQ('s', session.events[3].key);
+  ASSERT_FALSE(session.events[3].hasPosition);
+  ASSERT_EQ("i018.solution", session.events[3].text);
+  remove(filename);
+}
+
+// ____________________________________________________________________________
+TEST(SessionTest, malformed) {
+  const char* filename = "/tmp/SessionTest.session";
+  std::string error;
+  Session session;
+  FILE* file = fopen(filename, "wb");
+  fputs("HASHISE", file);
+  fclose(file);
+  ASSERT_FALSE(readSession(filename, &session, &error));
+  ASSERT_EQ(std::string(filename) + ": not a session", error);
+
+  // The name of the input file is longer than the rest.
+  file = fopen(filename, "wb");
+  fputs("HASHISES\x02\x06\x50\x18\x7Fi018", file);
+  fclose(file);
+  ASSERT_FALSE(readSession(filename, &session, &error));
+  ASSERT_EQ(std::string(filename) + ": session header is cut off", error);
+
+  // A click without its buttons.
+  file = fopen(filename, "wb");
+  fputs("HASHISES\x02\x06\x50\x18\x01x\x05\xE5\x0C\x32\x05", file);
+  fclose(file);
+  ASSERT_FALSE(readSession(filename, &session, &error));
+  ASSERT_EQ(std::string(filename) + ": malformed event at byte 14", error);
+
+  // The name of a solution file which is longer than the rest.
+  file = fopen(filename, "wb");
+  fputs("HASHISES\x02\x06\x50\x18\x01x\x05\xCE\x03\x09" "ab", file);
+  fclose(file);
+  ASSERT_FALSE(readSession(filename, &session, &error));
+  ASSERT_EQ(std::string(filename) + ": malformed event at byte 14", error);
+
+  // A session of the first version, without the texts.
+  file = fopen(filename, "wb");
+  fputs("HASHISES\x01\x06\x50\x18\x01x", file);
+  fclose(file);
+  ASSERT_FALSE(readSession(filename, &session, &error));
+  ASSERT_EQ(std::string(filename) + ": unsupported version 1", error);
+  remove(filename);
+}
@@ -0,0 +1,181 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./Board.h"
+#include "./Snapshot.h"
+
+static_assert(sizeof(SnapshotHeader) == 64, "the header has 64 bytes");
+
+const char kSnapshotMagic[8] = {'H', 'A', 'S', 'H', 'I', 'B', 'I', 'N'};
+
+// ____________________________________________________________________________
+void putVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// ____________________________________________________________________________
+const char* getVarint(const char* pos, const char* end, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+    uint8_t byte = *pos++;
+    *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (byte < 0x80) { return pos; }
+  }
+  return nullptr;
+}
+
+// ____________________________________________________________________________
+bool writeSnapshot(const std::string& filename, const Puzzle& puzzle,
+                   const Board* board, std::string* error) {
+  // The isles by row, so the rows and columns are small differences.
+  size_t n = puzzle.numIsles();
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; i++) { order[i] = i; }
+  std::sort(order.begin(), order.end(), [&puzzle](size_t a, size_t b) {
+    const PuzzleIsle& s = puzzle.getIsle(a);
+    const PuzzleIsle& t = puzzle.getIsle(b);
+    return s.y != t.y ? s.y < t.y : s.x < t.x;
+  });
+  Puzzle sorted;
+  std::string isles;
+  isles.reserve(2 * n);
+  for (size_t k = 0; k < n; k++) {
+    const PuzzleIsle& isle = puzzle.getIsle(order[k]);
+    sorted.addIsle(isle.x, isle.y, isle.value);
+    const PuzzleIsle* last = k > 0 ? &puzzle.getIsle(order[k - 1]) : nullptr;
+    size_t rows = isle.y - (last != nullptr ? last->y : 0);
+    size_t column = isle.x;
+    if (last != nullptr && rows == 0) { column -= last->x; }
+    putVarint(rows, &isles);
+    putVarint(column << 3 | (isle.value - 1), &isles);
+  }
+
+  // The records of the sorted isles with the bridges of the same isles on
+  // the board.
+  std::string bridges;
+  size_t numBridges = 0;
+  if (board != nullptr) {
+    Board records;
+    records.load(sorted);
+    numBridges = records.numBridges();
+    bridges.assign((numBridges + 3) / 4, 0);
+    for (size_t b = 0; b < numBridges; b++) {
+      int record = board->bridgeBetween(order[records.getStart(b)],
+                                        order[records.getEnd(b)]);
+      int count = record < 0 ? 0 : board->getCount(record);
+      bridges[b >> 2] |= count << ((b & 3) << 1);
+    }
+  }
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.headerSize = sizeof(header);
+  // The size is the one of the isles, readSnapshot() checks it.
+  for (size_t i = 0; i < n; i++) {
+    header.width = std::max<uint64_t>(header.width, puzzle.getIsle(i).x + 1);
+    header.height = std::max<uint64_t>(header.height,
+                                       puzzle.getIsle(i).y + 1);
+  }
+  header.numIsles = n;
+  header.numBridges = numBridges;
+  header.islesOffset = sizeof(header);
+  header.islesSize = isles.size();
+  header.bridgesOffset = header.islesOffset + isles.size();
+
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (file == NULL) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  fwrite(&header, sizeof(header), 1, file);
+  fwrite(isles.data(), 1, isles.size(), file);
+  fwrite(bridges.data(), 1, bridges.size(), file);
+  bool written = !ferror(file);
+  if (fclose(file) != 0 || !written) {
+    *error = "Error writing file: " + filename;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool readSnapshot(const char* begin, const char* end, Puzzle* puzzle,
+                  const uint8_t** bridges, size_t* numBridges,
+                  std::string* error) {
+  size_t size = end - begin;
+  SnapshotHeader header;
+  if (size < sizeof(header)) {
+    *error = "0: not a snapshot, too short";
+    return false;
+  }
+  memcpy(&header, begin, sizeof(header));
+  if (memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0) {
+    *error = "0: not a snapshot";
+    return false;
+  }
+  if (header.version != kSnapshotVersion) {
+    *error = "8: unsupported version " + std::to_string(header.version);
+    return false;
+  }
+  // Every isle takes at least two bytes, so a broken header can't make us
+  // loop for long.
+  if (header.headerSize < sizeof(header) || header.islesOffset > size ||
+      header.islesSize > size - header.islesOffset ||
+      header.numIsles > header.islesSize / 2 || header.bridgesOffset > size ||
+      (header.numBridges + 3) / 4 > size - header.bridgesOffset) {
+    *error = "0: snapshot is cut off";
+    return false;
+  }
+
+  *puzzle = Puzzle();
+  const char* pos = begin + header.islesOffset;
+  const char* islesEnd = pos + header.islesSize;
+  uint64_t x = 0;
+  uint64_t y = 0;
+  uint64_t width = 0;
+  for (uint64_t k = 0; k < header.numIsles; k++) {
+    const char* isle = pos;
+    uint64_t rows, packed;
+    pos = getVarint(pos, islesEnd, &rows);
+    if (pos != nullptr) { pos = getVarint(pos, islesEnd, &packed); }
+    if (pos != nullptr) {
+      x = (k > 0 && rows == 0 ? x : 0) + (packed >> 3);
+      y += rows;
+    }
+    if (pos == nullptr || x >= header.width || y >= header.height) {
+      *error = std::to_string(isle - begin) + ": malformed isle " +
+               std::to_string(k);
+      return false;
+    }
+    // The isles are sorted, so the same position comes right after.
+    if (k > 0 && rows == 0 && (packed >> 3) == 0) {
+      *error = std::to_string(isle - begin) + ": duplicate isle " +
+               std::to_string(k);
+      return false;
+    }
+    width = std::max(width, x + 1);
+    puzzle->addIsle(x, y, (packed & 7) + 1);
+  }
+  // A size larger than the isles would only make the board take memory,
+  // a broken header mustn't get us to allocate gigabytes.
+  uint64_t height = header.numIsles > 0 ? y + 1 : 0;
+  if (header.width != width || header.height != height) {
+    *error = "16: size " + std::to_string(header.width) + "x" +
+             std::to_string(header.height) + " doesn't match the isles";
+    return false;
+  }
+  *bridges = reinterpret_cast<const uint8_t*>(begin + header.bridgesOffset);
+  *numBridges = header.numBridges;
+  return true;
+}
@@ -0,0 +1,71 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "./Puzzle.h"
+
+class Board;
+
+// The binary *.hashi format for instances and games in progress. All
+// numbers are little endian. A file consists of:
+//
+//   header   SnapshotHeader, 64 bytes.
+//   isles    Sorted by row, then by column. Per isle a varint (7 bits per
+//            byte, lowest first) with the rows since the isle before and a
+//            varint with (column << 3 | value - 1), where column counts
+//            from the isle before if it's in the same row.
+//   bridges  2 bits per bridge record of a Board loaded with the isles in
+//            this order, 4 records per byte starting at the lowest bits.
+//
+// width and height are the ones of the isles, from (0, 0) up to the
+// rightmost and the lowest isle, and no two isles are at the same position.
+// The header and the bridges are used right from the mapped file, only the
+// isles have to be decoded. numBridges is 0 for a puzzle without a game.
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint32_t width;
+  uint32_t height;
+  uint64_t numIsles;
+  uint64_t numBridges;
+  uint64_t islesOffset;
+  uint64_t islesSize;
+  uint64_t bridgesOffset;
+};
+
+// "HASHIBIN" and the version readSnapshot() understands.
+extern const char kSnapshotMagic[8];
+const uint32_t kSnapshotVersion = 1;
+
+// Writes the isles of puzzle and the bridges of board, which has to be
+// loaded from puzzle (or nullptr for no bridges). Returns false and writes a
+// message to error if the file can't be written.
+bool writeSnapshot(const std::string& filename, const Puzzle& puzzle,
+                   const Board* board, std::string* error);
+
+// Reads a snapshot from begin up to end: the isles into puzzle and where
+// the bridges are into bridges and numBridges. Returns false and writes a
+// message to error if it isn't a valid snapshot.
+bool readSnapshot(const char* begin, const char* end, Puzzle* puzzle,
+                  const uint8_t** bridges, size_t* numBridges,
+                  std::string* error);
+
+// Appends value as a varint to out.
+void putVarint(uint64_t value, std::string* out);
+
+// Reads a varint at pos. Returns nullptr if it's cut off or too long,
+// otherwise the position behind it.
+const char* getVarint(const char* pos, const char* end, uint64_t* value);
+
+// The amount of bridges on record b of the bridge section.
+inline int snapshotBridges(const uint8_t* bridges, size_t b) {
+  return (bridges[b >> 2] >> ((b & 3) << 1)) & 3;
+}
+
+#endif  // SNAPSHOT_H_
@@ -0,0 +1,178 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "./Board.h"
+#include "./Puzzle.h"
+#include "./Snapshot.h"
+
+// ____________________________________________________________________________
+TEST(SnapshotTest, writeAndLoad) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Board board;
+  board.load(puzzle);
+  const char* solution = "0,0,9,0\n0,0,9,0\n0,0,0,7\n9,0,9,3\n0,7,12,7\n";
+  ASSERT_TRUE(board.parseSolution(solution, solution + strlen(solution),
+                                  &error)) << error;
+  const char* filename = "/tmp/SnapshotTest.hashi";
+  ASSERT_TRUE(writeSnapshot(filename, puzzle, &board, &error)) << error;
+
+  // Puzzle only takes the isles, sorted by row.
+  Puzzle isles;
+  ASSERT_TRUE(isles.load(filename, &error)) << error;
+  ASSERT_EQ(5u, isles.numIsles());
+  ASSERT_EQ(13u, isles.getWidth());
+  ASSERT_EQ(8u, isles.getHeight());
+  ASSERT_EQ(0u, isles.getIsle(0).x);
+  ASSERT_EQ(0u, isles.getIsle(0).y);
+  ASSERT_EQ(9u, isles.getIsle(1).x);
+  ASSERT_EQ(3, isles.getIsle(1).value);
+  ASSERT_EQ(12u, isles.getIsle(4).x);
+  ASSERT_EQ(7u, isles.getIsle(4).y);
+
+  // Board takes the bridges as well.
+  Board loaded;
+  Puzzle loadedPuzzle;
+  ASSERT_TRUE(loaded.loadSnapshot(filename, &loadedPuzzle, &error)) << error;
+  ASSERT_TRUE(loaded.solved());
+  int b = loaded.bridgeBetween(loaded.isleAt(0, 0), loaded.isleAt(9, 0));
+  ASSERT_EQ(2, loaded.getCount(b));
+
+  // Without a board there are no bridges.
+  ASSERT_TRUE(writeSnapshot(filename, puzzle, nullptr, &error)) << error;
+  ASSERT_TRUE(loaded.loadSnapshot(filename, &loadedPuzzle, &error)) << error;
+  ASSERT_EQ(5u, loaded.unsatisfied());
+
+  // Bridges which cross are checked like the ones of a solution.
+  Puzzle plus;
+  plus.addIsle(1, 0, 1);
+  plus.addIsle(0, 1, 1);
+  plus.addIsle(2, 1, 1);
+  plus.addIsle(1, 2, 1);
+  board.load(plus);
+  board.addBridge(board.bridgeBetween(0, 3));
+  board.addBridge(board.bridgeBetween(1, 2));
+  ASSERT_TRUE(writeSnapshot(filename, plus, &board, &error)) << error;
+  ASSERT_FALSE(loaded.loadSnapshot(filename, &loadedPuzzle, &error));
+  ASSERT_EQ(std::string(filename) + ": record 1: bridge crosses record 0",
+            error);
+  remove(filename);
+}
+
+// ____________________________________________________________________________
+TEST(SnapshotTest, readSnapshotRejectsBrokenFiles) {
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(300, 0, 2);
+  puzzle.addIsle(300, 200, 1);
+  Board board;
+  board.load(puzzle);
+  board.addBridge(board.bridgeBetween(0, 1));
+  board.addBridge(board.bridgeBetween(1, 2));
+  const char* filename = "/tmp/SnapshotTest.hashi";
+  std::string error;
+  ASSERT_TRUE(writeSnapshot(filename, puzzle, &board, &error)) << error;
+  FILE* file = fopen(filename, "rb");
+  std::vector<char> data(1000);
+  data.resize(fread(data.data(), 1, data.size(), file));
+  fclose(file);
+  remove(filename);
+  // 64 bytes header, 2 + 3 + 4 bytes of isles and 1 byte of bridges.
+  ASSERT_EQ(74u, data.size());
+
+  Puzzle loaded;
+  const uint8_t* bridges;
+  size_t records;
+  const char* begin = data.data();
+  ASSERT_TRUE(readSnapshot(begin, begin + data.size(), &loaded, &bridges,
+                           &records, &error)) << error;
+  ASSERT_EQ(3u, loaded.numIsles());
+  ASSERT_EQ(300u, loaded.getIsle(2).x);
+  ASSERT_EQ(200u, loaded.getIsle(2).y);
+  ASSERT_EQ(2u, records);
+  ASSERT_EQ(1, snapshotBridges(bridges, 0));
+  ASSERT_EQ(1, snapshotBridges(bridges, 1));
+
+  ASSERT_FALSE(readSnapshot(begin, begin + 73, &loaded, &bridges, &records,
+                            &error));
+  ASSERT_EQ("0: snapshot is cut off", error);
+  ASSERT_FALSE(readSnapshot(begin, begin + 10, &loaded, &bridges, &records,
+                            &error));
+  std::vector<char> broken = data;
+  broken[0] = 'X';
+  ASSERT_FALSE(readSnapshot(broken.data(), broken.data() + broken.size(),
+                            &loaded, &bridges, &records, &error));
+  ASSERT_EQ("0: not a snapshot", error);
+  broken = data;
+  broken[8] = 2;
+  ASSERT_FALSE(readSnapshot(broken.data(), broken.data() + broken.size(),
+                            &loaded, &bridges, &records, &error));
+  ASSERT_EQ("8: unsupported version 2", error);
+  // A board of height 100 is too small for the last isle.
+  broken = data;
+  broken[20] = 100;
+  broken[21] = 0;
+  ASSERT_FALSE(readSnapshot(broken.data(), broken.data() + broken.size(),
+                            &loaded, &bridges, &records, &error));
+  ASSERT_EQ("69: malformed isle 2", error);
+  // A board larger than its isles, which would only take memory.
+  broken = data;
+  broken[20] = 1;
+  broken[21] = 1;
+  ASSERT_FALSE(readSnapshot(broken.data(), broken.data() + broken.size(),
+                            &loaded, &bridges, &records, &error));
+  ASSERT_EQ("16: size 301x257 doesn't match the isles", error);
+
+  // Two isles at the same position.
+  Puzzle twice;
+  twice.addIsle(2, 1, 1);
+  twice.addIsle(2, 1, 1);
+  ASSERT_TRUE(writeSnapshot(filename, twice, nullptr, &error)) << error;
+  ASSERT_FALSE(loaded.load(filename, &error));
+  ASSERT_EQ(std::string(filename) + ":66: duplicate isle 1", error);
+  remove(filename);
+}
+
+// ____________________________________________________________________________
+TEST(SnapshotTest, loadHugeSnapshot) {
+  // A million isles, which only have to be decoded from their varints.
+  Puzzle puzzle;
+  for (size_t y = 0; y < 2000; y += 2) {
+    for (size_t x = 0; x < 2000; x += 2) { puzzle.addIsle(x, y, 1); }
+  }
+  const char* filename = "/tmp/SnapshotTest.hashi";
+  std::string error;
+  ASSERT_TRUE(writeSnapshot(filename, puzzle, nullptr, &error)) << error;
+  clock_t start = clock();
+  Puzzle loaded;
+  ASSERT_TRUE(loaded.load(filename, &error)) << error;
+  double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+  ASSERT_EQ(1000000u, loaded.numIsles());
+  ASSERT_EQ(1998u, loaded.getIsle(999999).x);
+  ASSERT_LT(seconds, 0.5) << seconds;
+
+  // A smaller game with every other bridge record built, the bridges are
+  // read right from the mapped file.
+  puzzle = Puzzle();
+  for (size_t y = 0; y < 200; y += 2) {
+    for (size_t x = 0; x < 200; x += 2) { puzzle.addIsle(x, y, 1); }
+  }
+  Board board;
+  board.load(puzzle);
+  for (size_t b = 0; b < board.numBridges(); b += 2) { board.addBridge(b); }
+  ASSERT_TRUE(writeSnapshot(filename, puzzle, &board, &error)) << error;
+  Board resumed;
+  ASSERT_TRUE(resumed.loadSnapshot(filename, &loaded, &error)) << error;
+  remove(filename);
+  ASSERT_EQ(board.numBridges(), resumed.numBridges());
+  for (size_t b = 0; b < board.numBridges(); b++) {
+    ASSERT_EQ(board.getCount(b), resumed.getCount(b));
+  }
+}
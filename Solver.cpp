@@ -0,0 +1,759 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "./Bitboard.h"
+#include "./Neighbours.h"
+#include "./Puzzle.h"
+#include "./Solver.h"
+
+// ____________________________________________________________________________
+Solver::Solver(const Puzzle& puzzle)
+    : _puzzle(puzzle), _cancelled(new std::atomic<bool>(false)) {
+  _visitStamp = 0;
+  _nextEdge = 0;
+  _nodes = 0;
+  _tableHits = 0;
+  buildEdges();
+  buildCrossings();
+  _queued.assign(_puzzle.numIsles(), 0);
+  _visited.assign(_puzzle.numIsles(), 0);
+}
+
+// ____________________________________________________________________________
+void Solver::buildEdges() {
+  size_t n = _puzzle.numIsles();
+  std::vector<std::pair<size_t, size_t>> points(n);
+  for (size_t i = 0; i < n; i++) {
+    points[i] = std::make_pair(_puzzle.getIsle(i).x, _puzzle.getIsle(i).y);
+  }
+  std::vector<std::array<int, 4>> neighbours = findNeighbours(points);
+
+  // Every isle pair gets one edge, starting at the left/upper isle.
+  std::array<int, 4> none = {{-1, -1, -1, -1}};
+  _incident.assign(n, none);
+  for (size_t i = 0; i < n; i++) {
+    for (Direction direction : {RIGHT, DOWN}) {
+      int j = neighbours[i][direction];
+      if (j < 0) { continue; }
+      int e = _edgeStart.size();
+      _edgeStart.push_back(i);
+      _edgeEnd.push_back(j);
+      _incident[i][direction] = e;
+      _incident[j][opposite(direction)] = e;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::buildCrossings() {
+  size_t edges = _edgeStart.size();
+  // Edges only cross in rows and columns with isles, so these are numbered
+  // by their rank and the rest of the board takes no memory.
+  std::vector<size_t> xs, ys;
+  for (size_t i = 0; i < _puzzle.numIsles(); i++) {
+    xs.push_back(_puzzle.getIsle(i).x);
+    ys.push_back(_puzzle.getIsle(i).y);
+  }
+  std::sort(xs.begin(), xs.end());
+  xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+  std::sort(ys.begin(), ys.end());
+  ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+  auto rank = [](const std::vector<size_t>& values, size_t v) -> size_t {
+    return std::lower_bound(values.begin(), values.end(), v) - values.begin();
+  };
+
+  // The horizontal edges of every row, from left to right, and the columns
+  // they pass in between their isles as bit rank(y) of column rank(x).
+  std::vector<std::vector<size_t>> rows(ys.size());
+  Bitboard covered;
+  covered.reset(xs.size(), ys.size());
+  for (size_t e = 0; e < edges; e++) {
+    const PuzzleIsle& s = _puzzle.getIsle(_edgeStart[e]);
+    const PuzzleIsle& t = _puzzle.getIsle(_edgeEnd[e]);
+    if (s.y != t.y) { continue; }
+    size_t row = rank(ys, s.y);
+    rows[row].push_back(e);
+    size_t last = rank(xs, t.x);
+    for (size_t x = rank(xs, s.x) + 1; x < last; x++) { covered.set(x, row); }
+  }
+  for (auto& row : rows) {
+    std::sort(row.begin(), row.end(), [this](size_t a, size_t b) {
+      return _puzzle.getIsle(_edgeStart[a]).x <
+             _puzzle.getIsle(_edgeStart[b]).x;
+    });
+  }
+
+  // A vertical edge crosses exactly the rows whose bit is set in its
+  // column, the bitboard skips the others 64 at a time. The one horizontal
+  // edge of such a row which spans the column is found by binary search.
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t e = 0; e < edges; e++) {
+    const PuzzleIsle& s = _puzzle.getIsle(_edgeStart[e]);
+    const PuzzleIsle& t = _puzzle.getIsle(_edgeEnd[e]);
+    if (s.x != t.x) { continue; }
+    size_t column = rank(xs, s.x);
+    size_t last = rank(ys, t.y);
+    for (size_t y = covered.find(column, rank(ys, s.y) + 1, last); y < last;
+         y = covered.find(column, y + 1, last)) {
+      const std::vector<size_t>& row = rows[y];
+      auto it = std::upper_bound(row.begin(), row.end(), s.x,
+                                 [this](size_t x, size_t h) {
+        return x < _puzzle.getIsle(_edgeStart[h]).x;
+      });
+      size_t h = *(it - 1);
+      pairs.push_back(std::make_pair(e, h));
+      pairs.push_back(std::make_pair(h, e));
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  _crossStart.assign(edges + 1, 0);
+  _crossEdges.resize(pairs.size());
+  for (size_t k = 0; k < pairs.size(); k++) {
+    _crossStart[pairs[k].first + 1]++;
+    _crossEdges[k] = pairs[k].second;
+  }
+  for (size_t e = 0; e < edges; e++) {
+    _crossStart[e + 1] += _crossStart[e];
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::initBounds() {
+  size_t edges = _edgeStart.size();
+  _lo.assign(edges, 0);
+  _hi.assign(edges, 0);
+  _trail.clear();
+  for (size_t e = 0; e < edges; e++) {
+    int a = _puzzle.getIsle(_edgeStart[e]).value;
+    int b = _puzzle.getIsle(_edgeEnd[e]).value;
+    _hi[e] = std::min(2, std::min(a, b));
+    // Two isles which would be saturated by each other form a closed
+    // component, that's only allowed if there are no other isles.
+    if (a == b && a <= 2 && _puzzle.numIsles() > 2) {
+      _hi[e] = a - 1;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool Solver::setBounds(size_t e, int lo, int hi) {
+  lo = std::max(lo, _lo[e]);
+  hi = std::min(hi, _hi[e]);
+  if (lo > hi) { return false; }
+  if (lo == _lo[e] && hi == _hi[e]) { return true; }
+
+  TrailEntry entry;
+  entry.edge = e;
+  entry.lo = _lo[e];
+  entry.hi = _hi[e];
+  _trail.record(entry);
+  bool firstBridge = _lo[e] == 0 && lo > 0;
+  if (_hi[e] > 0 && hi == 0) { _cutEdges.push_back(e); }
+  _lo[e] = lo;
+  _hi[e] = hi;
+
+  size_t ends[2] = {_edgeStart[e], _edgeEnd[e]};
+  for (size_t i : ends) {
+    if (!_queued[i]) {
+      _queued[i] = 1;
+      _queue.push_back(i);
+    }
+  }
+
+  if (firstBridge) {
+    // A bridge on e forbids every bridge crossing it.
+    for (size_t k = _crossStart[e]; k < _crossStart[e + 1]; k++) {
+      if (!setBounds(_crossEdges[k], 0, 0)) { return false; }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Solver::propagateIsle(size_t i) {
+  int value = _puzzle.getIsle(i).value;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    int sumLo = 0;
+    int sumHi = 0;
+    for (int e : _incident[i]) {
+      if (e < 0) { continue; }
+      sumLo += _lo[e];
+      sumHi += _hi[e];
+    }
+    if (sumLo > value || sumHi < value) { return false; }
+    for (int e : _incident[i]) {
+      if (e < 0) { continue; }
+      // The other edges can take at most sumHi - _hi[e] bridges and need at
+      // least sumLo - _lo[e] bridges.
+      int lo = value - (sumHi - _hi[e]);
+      int hi = value - (sumLo - _lo[e]);
+      if (lo > _lo[e] || hi < _hi[e]) {
+        if (!setBounds(e, lo, hi)) { return false; }
+        changed = true;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Solver::propagate() {
+  while (!_queue.empty()) {
+    size_t i = _queue.back();
+    _queue.pop_back();
+    _queued[i] = 0;
+    if (!propagateIsle(i)) {
+      for (size_t j : _queue) { _queued[j] = 0; }
+      _queue.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Solver::connected() {
+  size_t n = _puzzle.numIsles();
+  if (n == 0) { return true; }
+  _visitStamp++;
+  size_t count = 1;
+  _visited[0] = _visitStamp;
+  _stack.clear();
+  _stack.push_back(0);
+  while (!_stack.empty()) {
+    size_t i = _stack.back();
+    _stack.pop_back();
+    for (int e : _incident[i]) {
+      if (e < 0 || _hi[e] == 0) { continue; }
+      size_t j = _edgeStart[e] == i ? _edgeEnd[e] : _edgeStart[e];
+      if (_visited[j] != _visitStamp) {
+        _visited[j] = _visitStamp;
+        _stack.push_back(j);
+        count++;
+      }
+    }
+  }
+  return count == n;
+}
+
+// ____________________________________________________________________________
+bool Solver::stillConnected() {
+  size_t n = _puzzle.numIsles();
+  for (size_t e : _cutEdges) {
+    size_t stampA = ++_visitStamp;
+    size_t stampB = ++_visitStamp;
+    _stack.clear();
+    _otherStack.clear();
+    _stack.push_back(_edgeStart[e]);
+    _otherStack.push_back(_edgeEnd[e]);
+    _visited[_edgeStart[e]] = stampA;
+    _visited[_edgeEnd[e]] = stampB;
+    size_t sizeA = 1;
+    size_t sizeB = 1;
+    bool met = false;
+    while (!met) {
+      // A side which can't grow anymore is a component on its own.
+      if (_stack.empty()) {
+        if (sizeA < n) { _cutEdges.clear(); return false; }
+        break;
+      }
+      if (_otherStack.empty()) {
+        if (sizeB < n) { _cutEdges.clear(); return false; }
+        break;
+      }
+      for (int side = 0; side < 2 && !met; side++) {
+        std::vector<size_t>& stack = side == 0 ? _stack : _otherStack;
+        size_t own = side == 0 ? stampA : stampB;
+        size_t other = side == 0 ? stampB : stampA;
+        size_t& size = side == 0 ? sizeA : sizeB;
+        if (stack.empty()) { continue; }
+        size_t i = stack.back();
+        stack.pop_back();
+        for (int f : _incident[i]) {
+          if (f < 0 || _hi[f] == 0) { continue; }
+          size_t j = _edgeStart[f] == i ? _edgeEnd[f] : _edgeStart[f];
+          if (_visited[j] == other) {
+            met = true;
+            break;
+          }
+          if (_visited[j] != own) {
+            _visited[j] = own;
+            stack.push_back(j);
+            size++;
+          }
+        }
+      }
+    }
+  }
+  _cutEdges.clear();
+  return true;
+}
+
+// ____________________________________________________________________________
+int Solver::chooseEdge() {
+  // Prefer an edge of an isle with few undecided edges, there the search
+  // gets the most out of the propagation. We start where the last search
+  // stopped, because the edges in front of it are most likely decided.
+  int best = -1;
+  int bestScore = 5;
+  size_t edges = _lo.size();
+  for (size_t k = 0; k < edges; k++) {
+    size_t e = _nextEdge + k < edges ? _nextEdge + k : _nextEdge + k - edges;
+    if (_lo[e] == _hi[e]) { continue; }
+    int score = 4;
+    size_t ends[2] = {_edgeStart[e], _edgeEnd[e]};
+    for (size_t i : ends) {
+      int open = 0;
+      for (int f : _incident[i]) {
+        if (f >= 0 && _lo[f] != _hi[f]) { open++; }
+      }
+      score = std::min(score, open);
+    }
+    if (score < bestScore) {
+      best = e;
+      bestScore = score;
+      // An isle with only one open edge can't exist after propagate().
+      if (score <= 2) { break; }
+    }
+  }
+  if (best >= 0) { _nextEdge = best; }
+  return best;
+}
+
+// ____________________________________________________________________________
+void Solver::undoTo(size_t size) {
+  while (_trail.undoable() > size) {
+    const TrailEntry& entry = _trail.undo();
+    _lo[entry.edge] = entry.lo;
+    _hi[entry.edge] = entry.hi;
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::clearQueues() {
+  for (size_t j : _queue) { _queued[j] = 0; }
+  _queue.clear();
+  _cutEdges.clear();
+}
+
+// ____________________________________________________________________________
+bool Solver::propagateRoot() {
+  initBounds();
+  for (size_t i = 0; i < _puzzle.numIsles(); i++) {
+    _queued[i] = 1;
+    _queue.push_back(i);
+  }
+  _cutEdges.clear();
+  return propagate() && connected();
+}
+
+// ____________________________________________________________________________
+bool Solver::deduce() {
+  _nodes = 0;
+  if (propagateRoot()) { return true; }
+  clearQueues();
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Solver::isDecided(size_t e) const { return _lo[e] == _hi[e]; }
+
+// ____________________________________________________________________________
+bool Solver::solve() {
+  _nodes = 0;
+  _nextEdge = 0;
+  _cancelled->store(false);
+  if (!propagateRoot()) { return false; }
+  if (search(nullptr, 0)) { return true; }
+  undoTo(0);
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Solver::applyPath(const std::vector<Decision>& path) {
+  for (const Decision& decision : path) {
+    if (!setBounds(decision.edge, decision.value, decision.value) ||
+        !propagate() || !stillConnected()) {
+      clearQueues();
+      return false;
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Solver::search(Shared* shared, size_t worker) {
+  int first = chooseEdge();
+  if (first < 0) { return true; }
+  std::vector<Frame> stack;
+  Frame frame;
+  frame.edge = first;
+  frame.value = _hi[first];
+  frame.lo = _lo[first];
+  frame.trail = _trail.undoable();
+  stack.push_back(frame);
+
+  while (!stack.empty()) {
+    // Checked once per node, so a cancel() takes effect right away.
+    if (_cancelled->load(std::memory_order_relaxed)) { return false; }
+    if (shared != nullptr) { donate(shared, worker, &stack); }
+    Frame& top = stack.back();
+    if (top.value < top.lo) {
+      stack.pop_back();
+      continue;
+    }
+    int value = top.value--;
+    size_t edge = top.edge;
+    undoTo(top.trail);
+    _nodes++;
+    if (setBounds(edge, value, value) && propagate() && stillConnected()) {
+      int next = chooseEdge();
+      if (next < 0) { return true; }
+      frame.edge = next;
+      frame.value = _hi[next];
+      frame.lo = _lo[next];
+      frame.trail = _trail.undoable();
+      stack.push_back(frame);
+    } else {
+      clearQueues();
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+struct Solver::Shared {
+  explicit Shared(size_t threads) : queues(threads) {}
+
+  // The queue of one thread. The owner takes subtrees from the back, the
+  // others steal from the front, where the biggest subtrees are.
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::vector<Decision>> paths;
+  };
+  std::vector<Queue> queues;
+
+  // Subtrees in the queues plus the ones being searched. If it's 0, there
+  // is nothing left to do.
+  std::atomic<size_t> pending;
+
+  // Threads which are looking for a subtree.
+  std::atomic<size_t> hungry;
+
+  // The thread which found the solution or -1.
+  std::atomic<int> winner;
+};
+
+// ____________________________________________________________________________
+void Solver::donate(Shared* shared, size_t worker, std::vector<Frame>* stack) {
+  if (shared->hungry.load(std::memory_order_relaxed) == 0) { return; }
+  // The frames below the top have decided their edge to value + 1, the top
+  // is about to try its value. Give away the frame nearest to the root which
+  // has a value left to try, the top only if it keeps one for itself.
+  size_t n = stack->size();
+  size_t k = 0;
+  while (k < n && ((*stack)[k].value < (*stack)[k].lo ||
+                   (k == n - 1 && (*stack)[k].value == (*stack)[k].lo))) {
+    k++;
+  }
+  if (k == n) { return; }
+  Shared::Queue& queue = shared->queues[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (!queue.paths.empty()) { return; }
+  std::vector<Decision> path = _path;
+  Decision decision;
+  for (size_t j = 0; j < k; j++) {
+    decision.edge = (*stack)[j].edge;
+    decision.value = (*stack)[j].value + 1;
+    path.push_back(decision);
+  }
+  decision.edge = (*stack)[k].edge;
+  decision.value = (*stack)[k].value--;
+  path.push_back(decision);
+  shared->pending++;
+  queue.paths.push_back(path);
+}
+
+// ____________________________________________________________________________
+void Solver::work(Shared* shared, size_t worker) {
+  size_t root = _trail.undoable();
+  size_t threads = shared->queues.size();
+  bool hungry = false;
+  size_t idle = 0;
+  while (!_cancelled->load()) {
+    // First the own queue, then steal from the others.
+    bool found = false;
+    for (size_t k = 0; k < threads && !found; k++) {
+      Shared::Queue& queue = shared->queues[(worker + k) % threads];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.paths.empty()) { continue; }
+      if (k == 0) {
+        _path.swap(queue.paths.back());
+        queue.paths.pop_back();
+      } else {
+        _path.swap(queue.paths.front());
+        queue.paths.pop_front();
+      }
+      found = true;
+    }
+    if (!found) {
+      if (shared->pending.load() == 0) { break; }
+      if (!hungry) {
+        hungry = true;
+        shared->hungry++;
+      }
+      // Spin a little, the others give work away within one node. Then
+      // sleep, so waiting threads don't take the cores of working ones.
+      if (++idle < 64) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+      continue;
+    }
+    idle = 0;
+    if (hungry) {
+      hungry = false;
+      shared->hungry--;
+    }
+
+    undoTo(root);
+    if (applyPath(_path) && search(shared, worker)) {
+      int none = -1;
+      if (shared->winner.compare_exchange_strong(none, worker)) {
+        // Everybody else stops.
+        _cancelled->store(true);
+      }
+    }
+    shared->pending--;
+  }
+  if (hungry) { shared->hungry--; }
+}
+
+// ____________________________________________________________________________
+bool Solver::solveParallel(size_t threads) {
+  if (threads <= 1) { return solve(); }
+  _nodes = 0;
+  _nextEdge = 0;
+  _cancelled->store(false);
+  if (!propagateRoot()) { return false; }
+
+  // Every thread works on its own copy, which starts with the propagated
+  // bounds of the root. The whole tree is the first subtree.
+  Shared shared(threads);
+  shared.pending = 1;
+  shared.hungry = 0;
+  shared.winner = -1;
+  shared.queues[0].paths.push_back(std::vector<Decision>());
+  std::vector<Solver> workers(threads, *this);
+  std::vector<std::thread> pool;
+  for (size_t k = 1; k < threads; k++) {
+    pool.push_back(std::thread(&Solver::work, &workers[k], &shared, k));
+  }
+  workers[0].work(&shared, 0);
+  for (auto& thread : pool) { thread.join(); }
+
+  for (const Solver& worker : workers) { _nodes += worker._nodes; }
+  if (shared.winner.load() < 0) {
+    undoTo(0);
+    return false;
+  }
+  // The winner's bounds are the solution, all decided.
+  const Solver& winner = workers[shared.winner.load()];
+  _lo = winner._lo;
+  _hi = winner._hi;
+  return true;
+}
+
+// Mixes the bits of x, so similar inputs give unrelated keys (splitmix64).
+static uint64_t mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// ____________________________________________________________________________
+uint64_t Solver::stateKey() {
+  uint64_t key = 0;
+  size_t edges = _lo.size();
+  for (size_t e = 0; e < edges; e++) {
+    if (_lo[e] != _hi[e]) { key ^= _edgeKeys[9 * e + 3 * _lo[e] + _hi[e]]; }
+  }
+  // The isles are visited in order, so the label of a component is the
+  // first isle with undecided edges in it, no matter how the bridges got
+  // there.
+  size_t stamp = ++_visitStamp;
+  for (size_t i = 0; i < _puzzle.numIsles(); i++) {
+    int remaining = _puzzle.getIsle(i).value;
+    bool open = false;
+    for (int e : _incident[i]) {
+      if (e < 0) { continue; }
+      if (_lo[e] == _hi[e]) {
+        remaining -= _lo[e];
+      } else {
+        open = true;
+      }
+    }
+    if (!open) { continue; }
+    if (_visited[i] != stamp) {
+      _visited[i] = stamp;
+      _label[i] = i;
+      _stack.clear();
+      _stack.push_back(i);
+      while (!_stack.empty()) {
+        size_t j = _stack.back();
+        _stack.pop_back();
+        for (int f : _incident[j]) {
+          if (f < 0 || _lo[f] != _hi[f] || _lo[f] == 0) { continue; }
+          size_t k = _edgeStart[f] == j ? _edgeEnd[f] : _edgeStart[f];
+          if (_visited[k] != stamp) {
+            _visited[k] = stamp;
+            _label[k] = i;
+            _stack.push_back(k);
+          }
+        }
+      }
+    }
+    key ^= _isleKeys[9 * i + remaining];
+    key ^= mix(_isleKeys[9 * i] ^ mix(_label[i]));
+  }
+  return key;
+}
+
+// ____________________________________________________________________________
+struct Solver::CountFrame {
+  Frame frame;
+  uint64_t key;
+  size_t count;
+};
+
+// ____________________________________________________________________________
+size_t Solver::countSolutions(size_t limit) {
+  _nodes = 0;
+  _tableHits = 0;
+  _nextEdge = 0;
+  _cancelled->store(false);
+  if (_edgeKeys.empty()) {
+    // Fixed seed, so the counts are reproducible.
+    std::mt19937_64 random(2018);
+    _edgeKeys.resize(9 * _edgeStart.size());
+    for (uint64_t& key : _edgeKeys) { key = random(); }
+    _isleKeys.resize(9 * _puzzle.numIsles());
+    for (uint64_t& key : _isleKeys) { key = random(); }
+    _label.resize(_puzzle.numIsles());
+  }
+  if (limit == 0 || !propagateRoot()) {
+    undoTo(0);
+    clearQueues();
+    return 0;
+  }
+
+  // The same search as solve(), but it goes on after a solution. Every
+  // frame sums up the solutions below it and stores them in the table when
+  // all its values are done. Frames which are left early because of the
+  // limit are never stored, so the table only holds exact counts.
+  std::unordered_map<uint64_t, size_t> table;
+  const size_t kMaxTable = 1 << 22;
+  size_t found = 0;
+  std::vector<CountFrame> stack;
+  // Adds the solutions below the current state, if they are known, or
+  // pushes a new frame.
+  auto enter = [&]() {
+    int next = chooseEdge();
+    if (next < 0) {
+      found++;
+      if (!stack.empty()) { stack.back().count++; }
+      return;
+    }
+    CountFrame node;
+    node.key = stateKey();
+    auto it = table.find(node.key);
+    if (it != table.end()) {
+      _tableHits++;
+      found += it->second;
+      if (!stack.empty()) { stack.back().count += it->second; }
+      return;
+    }
+    node.frame.edge = next;
+    node.frame.value = _hi[next];
+    node.frame.lo = _lo[next];
+    node.frame.trail = _trail.undoable();
+    node.count = 0;
+    stack.push_back(node);
+  };
+  enter();
+  while (!stack.empty() && found < limit) {
+    if (_cancelled->load(std::memory_order_relaxed)) { break; }
+    Frame& top = stack.back().frame;
+    if (top.value < top.lo) {
+      CountFrame done = stack.back();
+      stack.pop_back();
+      if (table.size() < kMaxTable) { table[done.key] = done.count; }
+      if (!stack.empty()) { stack.back().count += done.count; }
+      continue;
+    }
+    int value = top.value--;
+    size_t edge = top.edge;
+    undoTo(top.trail);
+    _nodes++;
+    if (setBounds(edge, value, value) && propagate() && stillConnected()) {
+      enter();
+    } else {
+      clearQueues();
+    }
+  }
+  undoTo(0);
+  clearQueues();
+  return std::min(found, limit);
+}
+
+// ____________________________________________________________________________
+size_t Solver::getTableHits() const { return _tableHits; }
+
+// ____________________________________________________________________________
+void Solver::cancel() { _cancelled->store(true); }
+
+// ____________________________________________________________________________
+size_t Solver::numEdges() const { return _edgeStart.size(); }
+
+// ____________________________________________________________________________
+size_t Solver::getStart(size_t e) const { return _edgeStart[e]; }
+
+// ____________________________________________________________________________
+size_t Solver::getEnd(size_t e) const { return _edgeEnd[e]; }
+
+// ____________________________________________________________________________
+int Solver::getBridges(size_t e) const { return _lo[e]; }
+
+// ____________________________________________________________________________
+size_t Solver::getNodes() const { return _nodes; }
+
+// ____________________________________________________________________________
+bool Solver::writeSolution(const std::string& filename,
+                           std::string* error) const {
+  std::vector<SolutionRecord> records;
+  for (size_t e = 0; e < numEdges(); e++) {
+    if (_lo[e] == 0) { continue; }
+    const PuzzleIsle& s = _puzzle.getIsle(_edgeStart[e]);
+    const PuzzleIsle& t = _puzzle.getIsle(_edgeEnd[e]);
+    records.push_back(SolutionRecord{s.x, s.y, t.x, t.y, _lo[e]});
+  }
+  return writeSolutionFile(filename, records, error);
+}
@@ -0,0 +1,227 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "./Journal.h"
+#include "./Puzzle.h"
+
+// Headless solver for a Puzzle. Every pair of isles which can see each other
+// is an edge with 0, 1 or 2 bridges. The isle values are propagated onto the
+// bounds of their edges, crossing edges exclude each other and the edges
+// which may still carry a bridge have to connect all isles. What can't be
+// decided that way is found by a backtracking search.
+class Solver {
+ public:
+  // Builds the edges and crossings for the puzzle.
+  explicit Solver(const Puzzle& puzzle);
+
+  // Tries to solve the puzzle. Returns true if a solution was found.
+  bool solve();
+
+  // Only propagates, without any search. Returns false on a contradiction.
+  // If every edge is decided afterwards, getBridges() is the one and only
+  // solution.
+  bool deduce();
+
+  // Returns true if the amount of bridges on edge e is known.
+  bool isDecided(size_t e) const;
+
+  // The same with threads threads. The search tree is split into subtrees:
+  // a thread which runs out of work steals the untried subtree nearest to
+  // the root from another thread. All threads stop as soon as one of them
+  // found a solution.
+  bool solveParallel(size_t threads);
+
+  // Counts the solutions, but stops as soon as limit are found. Search
+  // states which are left with the same subproblem are only searched once,
+  // their count is kept in a transposition table under a Zobrist hash of
+  // the undecided edges, the bridges the isles still need and which isles
+  // the bridges so far connect (see stateKey()).
+  size_t countSolutions(size_t limit);
+
+  // Returns how often countSolutions() found a state in the table.
+  size_t getTableHits() const;
+
+  // Makes a running solve() or solveParallel() (and the ones of all copies
+  // of this solver) return false soon. Can be called from any thread.
+  void cancel();
+
+  // Returns the amount of edges (isle pairs which can be connected).
+  size_t numEdges() const;
+
+  // Returns the index of the left/upper and the right/lower isle of edge e.
+  size_t getStart(size_t e) const;
+  size_t getEnd(size_t e) const;
+
+  // Returns the amount of bridges on edge e after a successful solve().
+  int getBridges(size_t e) const;
+
+  // Returns the amount of search nodes the last solve() needed.
+  size_t getNodes() const;
+
+  // Writes the solution in the x1,y1,x2,y2 format of the *.solution files.
+  // A double bridge is written as two lines.
+  bool writeSolution(const std::string& filename, std::string* error) const;
+
+ private:
+  // One entry of the trail, so a bound change can be taken back.
+  struct TrailEntry {
+    size_t edge;
+    int lo;
+    int hi;
+  };
+
+  // One value of one edge. A path of decisions from the root is a subtree
+  // of the search, which is what the threads of solveParallel() share.
+  struct Decision {
+    size_t edge;
+    int value;
+  };
+
+  // The queues of the threads and everything else they share, see
+  // Solver.cpp.
+  struct Shared;
+
+  // A node of countSolutions(): its frame, its key and the solutions found
+  // below it.
+  struct CountFrame;
+
+  // One decision of the search.
+  struct Frame {
+    size_t edge;
+    int value;
+    int lo;
+    size_t trail;
+  };
+
+  // Creates an edge for every pair of neighbouring isles.
+  void buildEdges();
+
+  // Finds all pairs of a horizontal and a vertical edge which cross.
+  void buildCrossings();
+
+  // Resets the bounds to the ones given by the isle values.
+  void initBounds();
+
+  // Starts over with initBounds() and propagates everything. Returns false
+  // on a contradiction.
+  bool propagateRoot();
+
+  // Narrows the bounds of edge e. Returns false on a contradiction.
+  bool setBounds(size_t e, int lo, int hi);
+
+  // Checks the sum of the edges around isle i against its value.
+  bool propagateIsle(size_t i);
+
+  // Runs propagateIsle() until nothing changes anymore.
+  bool propagate();
+
+  // Checks whether the edges which may still get a bridge connect all isles.
+  bool connected();
+
+  // Checks whether the isles of every edge in _cutEdges are still connected
+  // by other edges. Both sides are searched in turns, so the cost depends on
+  // the smaller side only, if an edge split the board.
+  bool stillConnected();
+
+  // Returns the next undecided edge for the search or -1 if all are decided.
+  int chooseEdge();
+
+  // Takes back all bound changes until the trail has the given size.
+  void undoTo(size_t size);
+
+  // Forgets everything left in the queues after a contradiction.
+  void clearQueues();
+
+  // Sets the decisions and propagates them. Returns false on a
+  // contradiction.
+  bool applyPath(const std::vector<Decision>& path);
+
+  // Depth first search from the current bounds, every frame tries the values
+  // of one edge from the highest to the lowest. If shared isn't null, the
+  // search gives subtrees away to threads which have nothing to do.
+  bool search(Shared* shared, size_t worker);
+
+  // Zobrist hash of the rest of the puzzle: the bounds of every undecided
+  // edge, how many bridges every isle with undecided edges still needs and
+  // which of these isles are connected by the decided bridges. Two states
+  // with the same key have the same amount of solutions.
+  uint64_t stateKey();
+
+  // Moves the untried value nearest to the root of the stack into the queue
+  // of worker (if the queue is empty).
+  void donate(Shared* shared, size_t worker, std::vector<Frame>* stack);
+
+  // One thread of solveParallel(): takes subtrees from its own queue or
+  // steals them from the others until a solution is found or there are no
+  // subtrees left.
+  void work(Shared* shared, size_t worker);
+
+  const Puzzle& _puzzle;
+
+  // Both isles of every edge.
+  std::vector<size_t> _edgeStart;
+  std::vector<size_t> _edgeEnd;
+
+  // The edges of every isle in the order of Direction (-1 if there is none).
+  std::vector<std::array<int, 4>> _incident;
+
+  // The crossing edges of edge e are _crossEdges[_crossStart[e]] up to
+  // _crossEdges[_crossStart[e + 1] - 1].
+  std::vector<size_t> _crossStart;
+  std::vector<size_t> _crossEdges;
+
+  // Lower and upper bound for the amount of bridges on every edge.
+  std::vector<int> _lo;
+  std::vector<int> _hi;
+
+  // All bound changes since the start of the search.
+  Journal<TrailEntry> _trail;
+
+  // Isles which have to be checked again.
+  std::vector<size_t> _queue;
+  std::vector<char> _queued;
+
+  // Edges which lost their last possible bridge since the last check.
+  std::vector<size_t> _cutEdges;
+
+  // Marks and stacks for connected() and stillConnected().
+  std::vector<size_t> _visited;
+  size_t _visitStamp;
+  std::vector<size_t> _stack;
+  std::vector<size_t> _otherStack;
+
+  // The decisions which lead from the root to where search() started.
+  std::vector<Decision> _path;
+
+  // Random keys for stateKey(): 9 per edge (3 * lo + hi) and 9 per isle
+  // (the bridges it still needs).
+  std::vector<uint64_t> _edgeKeys;
+  std::vector<uint64_t> _isleKeys;
+
+  // The component of every isle in stateKey().
+  std::vector<size_t> _label;
+
+  // Hits in the table of countSolutions().
+  size_t _tableHits;
+
+  // Set by cancel(), shared with all copies.
+  std::shared_ptr<std::atomic<bool>> _cancelled;
+
+  // The search starts looking for an undecided edge here.
+  size_t _nextEdge;
+
+  // Amount of search nodes.
+  size_t _nodes;
+};
+
+#endif  // SOLVER_H_
@@ -0,0 +1,318 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <glob.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "./Puzzle.h"
+#include "./Solver.h"
+
+// Checks the values of all isles and whether the bridges connect them.
+static void expectValidSolution(const Puzzle& puzzle, const Solver& solver) {
+  std::vector<int> sum(puzzle.numIsles(), 0);
+  std::vector<size_t> parent(puzzle.numIsles());
+  for (size_t i = 0; i < parent.size(); i++) { parent[i] = i; }
+  size_t components = puzzle.numIsles();
+  for (size_t e = 0; e < solver.numEdges(); e++) {
+    int bridges = solver.getBridges(e);
+    if (bridges == 0) { continue; }
+    sum[solver.getStart(e)] += bridges;
+    sum[solver.getEnd(e)] += bridges;
+    size_t a = solver.getStart(e);
+    size_t b = solver.getEnd(e);
+    while (parent[a] != a) { a = parent[a]; }
+    while (parent[b] != b) { b = parent[b]; }
+    if (a != b) {
+      parent[a] = b;
+      components--;
+    }
+  }
+  for (size_t i = 0; i < puzzle.numIsles(); i++) {
+    ASSERT_EQ(puzzle.getIsle(i).value, sum[i]);
+  }
+  ASSERT_EQ(1u, components);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveSmallInstance) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error));
+  Solver solver(puzzle);
+  ASSERT_TRUE(solver.solve());
+  expectValidSolution(puzzle, solver);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, writeSolutionReportsFullDisk) {
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i018-n005-s13x08.xy", &error)) << error;
+  Solver solver(puzzle);
+  ASSERT_TRUE(solver.solve());
+  // The writes only fail when the buffer goes out, at the close.
+  ASSERT_FALSE(solver.writeSolution("/dev/full", &error));
+  ASSERT_EQ("Error writing file: /dev/full", error);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveAllInstances) {
+  glob_t files;
+  ASSERT_EQ(0, glob("i0*.xy", 0, NULL, &files));
+  ASSERT_LT(0u, files.gl_pathc);
+  for (size_t k = 0; k < files.gl_pathc; k++) {
+    Puzzle puzzle;
+    std::string error;
+    ASSERT_TRUE(puzzle.load(files.gl_pathv[k], &error)) << error;
+    Solver solver(puzzle);
+    ASSERT_TRUE(solver.solve()) << files.gl_pathv[k];
+    expectValidSolution(puzzle, solver);
+  }
+  globfree(&files);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveLargeBoard) {
+  // A comb of 150x150 isles: every row is a chain and the first column
+  // connects the rows. The bridge counts are random, so the solver has to
+  // find some solution for 22500 isles.
+  const size_t n = 150;
+  std::vector<int> value(n * n, 0);
+  srand(42);
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x < n; x++) {
+      int bridges = 1 + rand() % 2;
+      if (x + 1 < n) {
+        value[y * n + x] += bridges;
+        value[y * n + x + 1] += bridges;
+      } else if (y + 1 < n) {
+        value[y * n] += bridges;
+        value[(y + 1) * n] += bridges;
+      }
+    }
+  }
+  Puzzle puzzle;
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x < n; x++) {
+      puzzle.addIsle(2 * x, 2 * y, value[y * n + x]);
+    }
+  }
+  Solver solver(puzzle);
+  ASSERT_TRUE(solver.solve());
+  expectValidSolution(puzzle, solver);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveFarApartIsles) {
+  // A huge board with three isles takes no more room than three isles.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(999999, 0, 2);
+  puzzle.addIsle(999999, 999999, 1);
+  Solver solver(puzzle);
+  ASSERT_TRUE(solver.solve());
+  expectValidSolution(puzzle, solver);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveParallel) {
+  glob_t files;
+  ASSERT_EQ(0, glob("i0*.xy", 0, NULL, &files));
+  for (size_t k = 0; k < files.gl_pathc; k++) {
+    Puzzle puzzle;
+    std::string error;
+    ASSERT_TRUE(puzzle.load(files.gl_pathv[k], &error)) << error;
+    Solver solver(puzzle);
+    ASSERT_TRUE(solver.solveParallel(4)) << files.gl_pathv[k];
+    expectValidSolution(puzzle, solver);
+  }
+  globfree(&files);
+
+  // Without a solution all threads have to give up. A 2 in between two 1s
+  // in a row and a 3 below the 2: 2 + 1 + 1 can't be 3 and 4 together.
+  Puzzle puzzle;
+  puzzle.addIsle(0, 0, 1);
+  puzzle.addIsle(2, 0, 4);
+  puzzle.addIsle(4, 0, 1);
+  puzzle.addIsle(2, 2, 1);
+  Solver solver(puzzle);
+  ASSERT_FALSE(solver.solveParallel(4));
+  ASSERT_FALSE(solver.solve());
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, solveParallelLargeBoard) {
+  // A board which needs search: rows of isles with 2 bridges each, where
+  // the rows are connected at random columns.
+  const size_t n = 40;
+  Puzzle puzzle;
+  std::vector<int> value(n * n, 0);
+  srand(7);
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x + 1 < n; x++) {
+      int bridges = 1 + rand() % 2;
+      value[y * n + x] += bridges;
+      value[y * n + x + 1] += bridges;
+    }
+    if (y + 1 < n) {
+      size_t x = rand() % n;
+      value[y * n + x] += 1;
+      value[(y + 1) * n + x] += 1;
+    }
+  }
+  for (size_t y = 0; y < n; y++) {
+    for (size_t x = 0; x < n; x++) {
+      puzzle.addIsle(2 * x, 2 * y, value[y * n + x]);
+    }
+  }
+  Solver solver(puzzle);
+  ASSERT_TRUE(solver.solveParallel(8));
+  expectValidSolution(puzzle, solver);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, countSolutions) {
+  // Every instance has one solution, except i013: four 3s in a square can
+  // have the double bridges on either pair of opposite sides.
+  glob_t files;
+  ASSERT_EQ(0, glob("i0*.xy", 0, NULL, &files));
+  for (size_t k = 0; k < files.gl_pathc; k++) {
+    Puzzle puzzle;
+    std::string error;
+    ASSERT_TRUE(puzzle.load(files.gl_pathv[k], &error)) << error;
+    Solver solver(puzzle);
+    bool square = strstr(files.gl_pathv[k], "i013") != NULL;
+    ASSERT_EQ(square ? 2u : 1u, solver.countSolutions(10))
+        << files.gl_pathv[k];
+    // Counting leaves the bounds as they were, so solve() still works.
+    ASSERT_TRUE(solver.solve());
+    expectValidSolution(puzzle, solver);
+  }
+  globfree(&files);
+
+  Puzzle puzzle;
+  std::string error;
+  ASSERT_TRUE(puzzle.load("i013-n004-s07x03.xy", &error));
+  Solver solver(puzzle);
+  ASSERT_EQ(1u, solver.countSolutions(1));
+  ASSERT_EQ(0u, solver.countSolutions(0));
+}
+
+// Returns true if the bridge counts on the edges of the solver solve the
+// puzzle, with the same checks as expectValidSolution() plus crossings.
+static bool isSolution(const Puzzle& puzzle, const Solver& solver,
+                       const std::vector<int>& bridges) {
+  std::vector<int> sum(puzzle.numIsles(), 0);
+  std::vector<size_t> parent(puzzle.numIsles());
+  for (size_t i = 0; i < parent.size(); i++) { parent[i] = i; }
+  size_t components = puzzle.numIsles();
+  for (size_t e = 0; e < bridges.size(); e++) {
+    if (bridges[e] == 0) { continue; }
+    size_t a = solver.getStart(e);
+    size_t b = solver.getEnd(e);
+    sum[a] += bridges[e];
+    sum[b] += bridges[e];
+    const PuzzleIsle& s = puzzle.getIsle(a);
+    const PuzzleIsle& t = puzzle.getIsle(b);
+    for (size_t f = 0; f < bridges.size(); f++) {
+      if (bridges[f] == 0 || s.y != t.y) { continue; }
+      const PuzzleIsle& u = puzzle.getIsle(solver.getStart(f));
+      const PuzzleIsle& v = puzzle.getIsle(solver.getEnd(f));
+      if (u.x == v.x && s.x < u.x && u.x < t.x && u.y < s.y && s.y < v.y) {
+        return false;
+      }
+    }
+    while (parent[a] != a) { a = parent[a]; }
+    while (parent[b] != b) { b = parent[b]; }
+    if (a != b) {
+      parent[a] = b;
+      components--;
+    }
+  }
+  for (size_t i = 0; i < puzzle.numIsles(); i++) {
+    if (sum[i] != puzzle.getIsle(i).value) { return false; }
+  }
+  return components == 1;
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, countSolutionsLikeBruteForce) {
+  // Small random boards with the values of random bridges which solve them,
+  // counted once more by trying all 3^edges bridge counts.
+  srand(11);
+  size_t ambiguous = 0;
+  for (int round = 0; round < 100; round++) {
+    Puzzle layout;
+    std::vector<bool> taken(16, false);
+    for (int k = 0; k < 9; k++) {
+      size_t cell = rand() % 16;
+      if (taken[cell]) { continue; }
+      taken[cell] = true;
+      layout.addIsle(cell % 4, cell / 4, 0);
+    }
+    Solver edges(layout);
+    size_t m = edges.numEdges();
+    if (m > 10) { continue; }
+    std::vector<int> bridges(m);
+    std::vector<int> value(layout.numIsles());
+    bool solution = false;
+    for (int attempt = 0; attempt < 100 && !solution; attempt++) {
+      std::fill(value.begin(), value.end(), 0);
+      for (size_t e = 0; e < m; e++) {
+        bridges[e] = rand() % 3;
+        value[edges.getStart(e)] += bridges[e];
+        value[edges.getEnd(e)] += bridges[e];
+      }
+      Puzzle puzzle;
+      for (size_t i = 0; i < layout.numIsles(); i++) {
+        puzzle.addIsle(layout.getIsle(i).x, layout.getIsle(i).y, value[i]);
+      }
+      solution = isSolution(puzzle, edges, bridges);
+    }
+    if (!solution) { continue; }
+    Puzzle puzzle;
+    for (size_t i = 0; i < layout.numIsles(); i++) {
+      puzzle.addIsle(layout.getIsle(i).x, layout.getIsle(i).y, value[i]);
+    }
+
+    size_t expected = 0;
+    size_t total = 1;
+    for (size_t e = 0; e < m; e++) { total *= 3; }
+    for (size_t code = 0; code < total; code++) {
+      size_t rest = code;
+      for (size_t e = 0; e < m; e++) {
+        bridges[e] = rest % 3;
+        rest /= 3;
+      }
+      if (isSolution(puzzle, edges, bridges)) { expected++; }
+    }
+    if (expected > 1) { ambiguous++; }
+    Solver solver(puzzle);
+    ASSERT_EQ(expected, solver.countSolutions(1000)) << "round " << round;
+  }
+  ASSERT_LT(0u, ambiguous);
+}
+
+// ____________________________________________________________________________
+TEST(SolverTest, countSolutionsLargeBoard) {
+  // A chain of 30 squares of 3s, linked by single bridges in the top row.
+  // The first square has 2 solutions and every further one 4, that's 2^59.
+  // Without the table the search would visit every one of them, with it
+  // every square is only counted a few times.
+  const size_t n = 30;
+  Puzzle puzzle;
+  for (size_t k = 0; k < n; k++) {
+    puzzle.addIsle(4 * k, 0, k > 0 ? 4 : 3);
+    puzzle.addIsle(4 * k + 2, 0, k + 1 < n ? 4 : 3);
+    puzzle.addIsle(4 * k, 2, 3);
+    puzzle.addIsle(4 * k + 2, 2, 3);
+  }
+  Solver solver(puzzle);
+  ASSERT_EQ(size_t(1) << 59, solver.countSolutions(SIZE_MAX));
+  ASSERT_LT(0u, solver.getTableHits());
+  ASSERT_LT(solver.getNodes(), 100000u);
+  // With a limit it stops early.
+  ASSERT_EQ(1000u, solver.countSolutions(1000));
+}
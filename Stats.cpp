@@ -0,0 +1,155 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "./Stats.h"
+
+static const char* const kNames[kNumStatOperations] = {
+  "input", "is_isle", "blocked", "new_bridge", "undo", "redo", "victory",
+  "draw_bridge", "draw_board", "show_state", "refresh"
+};
+
+// ____________________________________________________________________________
+Stats::Stats() {
+  _enabled = false;
+  clear();
+}
+
+// ____________________________________________________________________________
+void Stats::setEnabled(bool enabled) { _enabled = enabled; }
+
+// ____________________________________________________________________________
+void Stats::record(StatOperation operation, uint64_t nanos) {
+  _calls[operation]++;
+  _nanos[operation] += nanos;
+  _histograms[operation][bucketOf(nanos)]++;
+}
+
+// ____________________________________________________________________________
+void Stats::countFrame(size_t cells) {
+  _frames++;
+  _cells += cells;
+}
+
+// ____________________________________________________________________________
+void Stats::clear() {
+  _calls.fill(0);
+  _nanos.fill(0);
+  for (auto& histogram : _histograms) { histogram.fill(0); }
+  _frames = 0;
+  _cells = 0;
+}
+
+// ____________________________________________________________________________
+uint64_t Stats::calls(StatOperation operation) const {
+  return _calls[operation];
+}
+
+// ____________________________________________________________________________
+uint64_t Stats::totalNanos(StatOperation operation) const {
+  return _nanos[operation];
+}
+
+// ____________________________________________________________________________
+uint64_t Stats::bucket(StatOperation operation, size_t k) const {
+  return _histograms[operation][k];
+}
+
+// ____________________________________________________________________________
+uint64_t Stats::frames() const { return _frames; }
+
+// ____________________________________________________________________________
+uint64_t Stats::cells() const { return _cells; }
+
+// ____________________________________________________________________________
+size_t Stats::bucketOf(uint64_t nanos) {
+  if (nanos < 2) { return 0; }
+  size_t k = 63 - __builtin_clzll(nanos);
+  return k < kBuckets ? k : kBuckets - 1;
+}
+
+// ____________________________________________________________________________
+const char* Stats::name(StatOperation operation) { return kNames[operation]; }
+
+// ____________________________________________________________________________
+std::string Stats::text() const {
+  std::string result;
+  char line[160];
+  snprintf(line, sizeof(line), "%-12s %10s %12s %10s %10s\n", "operation",
+           "calls", "total_ms", "mean_ns", "max_ns<");
+  result += line;
+  for (size_t op = 0; op < kNumStatOperations; op++) {
+    if (_calls[op] == 0) { continue; }
+    // The upper end of the slowest bucket.
+    size_t slowest = 0;
+    for (size_t k = 0; k < kBuckets; k++) {
+      if (_histograms[op][k] > 0) { slowest = k; }
+    }
+    snprintf(line, sizeof(line), "%-12s %10llu %12.3f %10llu %10llu\n",
+             kNames[op], static_cast<unsigned long long>(_calls[op]),
+             _nanos[op] / 1e6,
+             static_cast<unsigned long long>(_nanos[op] / _calls[op]),
+             2ull << slowest);
+    result += line;
+  }
+  snprintf(line, sizeof(line), "frames %llu, cells written %llu\n",
+           static_cast<unsigned long long>(_frames),
+           static_cast<unsigned long long>(_cells));
+  return result + line;
+}
+
+// ____________________________________________________________________________
+std::string Stats::json() const {
+  // The histograms only with their buckets which aren't empty, as
+  // "lower bound in ns": calls.
+  std::string result = "{\"operations\": {";
+  bool first = true;
+  for (size_t op = 0; op < kNumStatOperations; op++) {
+    if (_calls[op] == 0) { continue; }
+    if (!first) { result += ", "; }
+    first = false;
+    result += "\"" + std::string(kNames[op]) + "\": {\"calls\": " +
+              std::to_string(_calls[op]) + ", \"total_ns\": " +
+              std::to_string(_nanos[op]) + ", \"histogram_ns\": {";
+    bool firstBucket = true;
+    for (size_t k = 0; k < kBuckets; k++) {
+      if (_histograms[op][k] == 0) { continue; }
+      if (!firstBucket) { result += ", "; }
+      firstBucket = false;
+      result += "\"" + std::to_string(k == 0 ? 0 : 1ull << k) + "\": " +
+                std::to_string(_histograms[op][k]);
+    }
+    result += "}}";
+  }
+  return result + "}, \"frames\": " + std::to_string(_frames) +
+         ", \"cells_written\": " + std::to_string(_cells) + "}\n";
+}
+
+// ____________________________________________________________________________
+bool Stats::dump(const std::string& filename, std::string* error) const {
+  const std::string ending = ".json";
+  bool json = filename.size() >= ending.size() &&
+              filename.compare(filename.size() - ending.size(), ending.size(),
+                               ending) == 0;
+  FILE* file = fopen(filename.c_str(), "w");
+  if (file == NULL) {
+    *error = "Error opening file: " + filename;
+    return false;
+  }
+  std::string content = json ? this->json() : text();
+  fwrite(content.data(), 1, content.size(), file);
+  bool written = !ferror(file);
+  if (fclose(file) != 0 || !written) {
+    *error = "Error writing file: " + filename;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+Stats& gameStats() {
+  static Stats stats;
+  return stats;
+}
@@ -0,0 +1,125 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <array>
+#include <chrono>
+#include <string>
+
+// The operations of the game which are timed.
+enum StatOperation {
+  STAT_INPUT = 0,
+  STAT_IS_ISLE,
+  STAT_BLOCKED,
+  STAT_NEW_BRIDGE,
+  STAT_UNDO,
+  STAT_REDO,
+  STAT_VICTORY,
+  STAT_DRAW_BRIDGE,
+  STAT_DRAW_BOARD,
+  STAT_SHOW_STATE,
+  STAT_REFRESH,
+  kNumStatOperations
+};
+
+// Call counts, time and a latency histogram per operation, and how many
+// frames and cells went to the terminal. Only the thread of the game
+// records, so nothing is locked. Recording costs two clock reads and a few
+// additions while enabled and a single branch while disabled.
+class Stats {
+ public:
+  // Bucket k of a histogram counts the calls which took at least 2^k ns
+  // (bucket 0 also the faster ones) and less than 2^(k + 1) ns, the last
+  // bucket everything slower.
+  static const size_t kBuckets = 40;
+
+  // Constructor, disabled and empty.
+  Stats();
+
+  // Turns the recording on and off, the numbers so far are kept.
+  void setEnabled(bool enabled);
+  bool enabled() const { return _enabled; }
+
+  // Records one call of operation which took nanos ns.
+  void record(StatOperation operation, uint64_t nanos);
+
+  // Records one frame which wrote cells cells.
+  void countFrame(size_t cells);
+
+  // Forgets everything recorded so far.
+  void clear();
+
+  // The numbers so far.
+  uint64_t calls(StatOperation operation) const;
+  uint64_t totalNanos(StatOperation operation) const;
+  uint64_t bucket(StatOperation operation, size_t k) const;
+  uint64_t frames() const;
+  uint64_t cells() const;
+
+  // Returns the bucket of a call which took nanos ns.
+  static size_t bucketOf(uint64_t nanos);
+
+  // Name of the operation in the dumps, e.g. "is_isle".
+  static const char* name(StatOperation operation);
+
+  // A table for people and the same as one JSON object.
+  std::string text() const;
+  std::string json() const;
+
+  // Writes json() to filename if it ends in .json, otherwise text().
+  bool dump(const std::string& filename, std::string* error) const;
+
+ private:
+  bool _enabled;
+  std::array<uint64_t, kNumStatOperations> _calls;
+  std::array<uint64_t, kNumStatOperations> _nanos;
+  std::array<std::array<uint64_t, kBuckets>, kNumStatOperations> _histograms;
+  uint64_t _frames;
+  uint64_t _cells;
+};
+
+// The stats of the game.
+Stats& gameStats();
+
+// Times its scope for the operation, if the stats of the game are enabled
+// when it's created.
+class StatTimer {
+ public:
+  explicit StatTimer(StatOperation operation)
+      : _operation(operation), _enabled(gameStats().enabled()) {
+    if (_enabled) { _start = std::chrono::steady_clock::now(); }
+  }
+
+  ~StatTimer() {
+    if (!_enabled) { return; }
+    std::chrono::nanoseconds nanos = std::chrono::steady_clock::now() - _start;
+    gameStats().record(_operation, nanos.count());
+  }
+
+ private:
+  StatOperation _operation;
+  bool _enabled;
+  std::chrono::steady_clock::time_point _start;
+};
+
+// The instrumentation of the game. Without HASHI_STATS (see the Makefile)
+// these are empty and nothing of it is compiled in.
+#ifdef HASHI_STATS
+#define HASHI_STATS_JOIN2(a, b) a##b
+#define HASHI_STATS_JOIN(a, b) HASHI_STATS_JOIN2(a, b)
+#define STAT_TIMER(operation) \
+  StatTimer HASHI_STATS_JOIN(statTimer, __LINE__)(operation)
+#define STAT_FRAME(cells) \
+  do { \
+    if (gameStats().enabled()) { gameStats().countFrame(cells); } \
+  } while (false)
+#else
+#define STAT_TIMER(operation)
+#define STAT_FRAME(cells) do {} while (false)
+#endif
+
+#endif  // STATS_H_
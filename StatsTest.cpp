@@ -0,0 +1,75 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "./Stats.h"
+
+// ____________________________________________________________________________
+TEST(StatsTest, record) {
+  ASSERT_EQ(0u, Stats::bucketOf(0));
+  ASSERT_EQ(0u, Stats::bucketOf(1));
+  ASSERT_EQ(1u, Stats::bucketOf(3));
+  ASSERT_EQ(10u, Stats::bucketOf(1024));
+  ASSERT_EQ(10u, Stats::bucketOf(2047));
+  ASSERT_EQ(Stats::kBuckets - 1, Stats::bucketOf(~0ull));
+
+  Stats stats;
+  ASSERT_FALSE(stats.enabled());
+  stats.record(STAT_IS_ISLE, 100);
+  stats.record(STAT_IS_ISLE, 120);
+  stats.record(STAT_IS_ISLE, 5000);
+  stats.record(STAT_REFRESH, 2000000);
+  stats.countFrame(44);
+  stats.countFrame(6);
+  ASSERT_EQ(3u, stats.calls(STAT_IS_ISLE));
+  ASSERT_EQ(5220u, stats.totalNanos(STAT_IS_ISLE));
+  ASSERT_EQ(2u, stats.bucket(STAT_IS_ISLE, 6));
+  ASSERT_EQ(1u, stats.bucket(STAT_IS_ISLE, 12));
+  ASSERT_EQ(0u, stats.calls(STAT_BLOCKED));
+  ASSERT_EQ(2u, stats.frames());
+  ASSERT_EQ(50u, stats.cells());
+
+  ASSERT_EQ("{\"operations\": {\"is_isle\": {\"calls\": 3, \"total_ns\": 5220, "
+            "\"histogram_ns\": {\"64\": 2, \"4096\": 1}}, \"refresh\": "
+            "{\"calls\": 1, \"total_ns\": 2000000, \"histogram_ns\": "
+            "{\"1048576\": 1}}}, \"frames\": 2, \"cells_written\": 50}\n",
+            stats.json());
+  std::string text = stats.text();
+  ASSERT_NE(std::string::npos, text.find("is_isle"));
+  ASSERT_NE(std::string::npos, text.find("frames 2, cells written 50"));
+  ASSERT_EQ(std::string::npos, text.find("blocked"));
+
+  stats.clear();
+  ASSERT_EQ(0u, stats.calls(STAT_IS_ISLE));
+  ASSERT_EQ(0u, stats.frames());
+}
+
+// ____________________________________________________________________________
+TEST(StatsTest, timerAndDump) {
+  // The timer only records while the stats of the game are enabled.
+  Stats& stats = gameStats();
+  stats.clear();
+  { StatTimer timer(STAT_UNDO); }
+  ASSERT_EQ(0u, stats.calls(STAT_UNDO));
+  stats.setEnabled(true);
+  { StatTimer timer(STAT_UNDO); }
+  stats.setEnabled(false);
+  ASSERT_EQ(1u, stats.calls(STAT_UNDO));
+
+  // The ending of the file decides the format.
+  std::string error;
+  const char* filename = "/tmp/StatsTest.json";
+  ASSERT_TRUE(stats.dump(filename, &error)) << error;
+  FILE* file = fopen(filename, "r");
+  std::vector<char> data(1000);
+  data.resize(fread(data.data(), 1, data.size(), file));
+  fclose(file);
+  remove(filename);
+  ASSERT_EQ(stats.json(), std::string(data.data(), data.size()));
+  ASSERT_FALSE(stats.dump("/nonexistent/stats.txt", &error));
+  ASSERT_EQ("Error opening file: /nonexistent/stats.txt", error);
+  stats.clear();
+}
@@ -0,0 +1,60 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <utility>
+#include <vector>
+#include "./UnionFind.h"
+
+// ____________________________________________________________________________
+UnionFind::UnionFind() {
+  _components = 0;
+}
+
+// ____________________________________________________________________________
+void UnionFind::reset(size_t n) {
+  _parent.resize(n);
+  _size.assign(n, 1);
+  for (size_t i = 0; i < n; i++) { _parent[i] = i; }
+  _history.clear();
+  _components = n;
+}
+
+// ____________________________________________________________________________
+size_t UnionFind::find(size_t i) const {
+  // Union by size keeps the trees flat, so this takes O(log n).
+  while (_parent[i] != i) { i = _parent[i]; }
+  return i;
+}
+
+// ____________________________________________________________________________
+bool UnionFind::unite(size_t a, size_t b) {
+  a = find(a);
+  b = find(b);
+  if (a == b) { return false; }
+  if (_size[a] < _size[b]) { std::swap(a, b); }
+  // The smaller tree gets hung below the bigger one.
+  _parent[b] = a;
+  _size[a] += _size[b];
+  _history.push_back(b);
+  _components--;
+  return true;
+}
+
+// ____________________________________________________________________________
+size_t UnionFind::checkpoint() const { return _history.size(); }
+
+// ____________________________________________________________________________
+void UnionFind::rollback(size_t checkpoint) {
+  while (_history.size() > checkpoint) {
+    size_t b = _history.back();
+    _history.pop_back();
+    size_t a = _parent[b];
+    _size[a] -= _size[b];
+    _parent[b] = b;
+    _components++;
+  }
+}
+
+// ____________________________________________________________________________
+size_t UnionFind::components() const { return _components; }
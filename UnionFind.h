@@ -0,0 +1,49 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef UNIONFIND_H_
+#define UNIONFIND_H_
+
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+// Union-find over the isles which can take back its unions in reverse
+// order. There is no path compression, so every union is exactly one
+// change, which is remembered on a history stack.
+class UnionFind {
+ public:
+  // Constructor.
+  UnionFind();
+
+  // Starts over with n single elements.
+  void reset(size_t n);
+
+  // Returns the representative of the set i belongs to.
+  size_t find(size_t i) const;
+
+  // Unites the sets of a and b. Returns false if they were already one set.
+  bool unite(size_t a, size_t b);
+
+  // Returns the current state, which can be restored with rollback().
+  size_t checkpoint() const;
+
+  // Takes back all unions since the given checkpoint.
+  void rollback(size_t checkpoint);
+
+  // Returns the amount of sets.
+  size_t components() const;
+
+ private:
+  // Parent and size of every element.
+  std::vector<size_t> _parent;
+  std::vector<size_t> _size;
+
+  // The element which got a new parent with every union.
+  std::vector<size_t> _history;
+
+  // Amount of sets.
+  size_t _components;
+};
+
+#endif  // UNIONFIND_H_
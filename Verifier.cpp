@@ -0,0 +1,87 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "./Board.h"
+#include "./FixedBoard.h"
+#include "./MappedFile.h"
+#include "./Parallel.h"
+#include "./Puzzle.h"
+#include "./Verifier.h"
+
+// Checks the text of a solution file on a FixedBoard, for visitFixedBoard().
+struct FixedCheck {
+  const char* begin;
+  const char* end;
+  bool valid;
+  size_t unsatisfied;
+  size_t components;
+
+  template <typename FixedBoardType>
+  void operator()(FixedBoardType* board) {
+    valid = board->parseSolution(begin, end);
+    if (!valid) { return; }
+    unsatisfied = board->unsatisfied();
+    components = board->components();
+  }
+};
+
+// ____________________________________________________________________________
+Verdict verifySolution(const std::string& instance,
+                       const std::string& solution) {
+  Verdict verdict;
+  verdict.result = Verdict::INVALID;
+  verdict.isles = 0;
+  Puzzle puzzle;
+  if (!puzzle.load(instance, &verdict.message)) { return verdict; }
+  verdict.isles = puzzle.numIsles();
+  MappedFile file;
+  if (!file.open(solution, &verdict.message)) { return verdict; }
+  // Small puzzles are checked without allocating anything. Only a broken
+  // file goes through the Board as well, which tells what is wrong with it.
+  FixedCheck check = {file.begin(), file.end(), false, 0, 0};
+  if (!visitFixedBoard(puzzle, &check) || !check.valid) {
+    Board board;
+    board.load(puzzle);
+    if (!board.parseSolution(file.begin(), file.end(), &verdict.message)) {
+      verdict.message = solution + ":" + verdict.message;
+      return verdict;
+    }
+    check.unsatisfied = board.unsatisfied();
+    check.components = board.components();
+  }
+  if (check.unsatisfied > 0 || check.components > 1) {
+    verdict.result = Verdict::WRONG;
+    verdict.message = std::to_string(check.unsatisfied) +
+                      " isles without the right amount of bridges, " +
+                      std::to_string(check.components) + " groups of isles";
+    return verdict;
+  }
+  verdict.result = Verdict::CORRECT;
+  return verdict;
+}
+
+// ____________________________________________________________________________
+std::vector<Verdict> verifyAll(const std::vector<VerifyJob>& jobs,
+                               size_t threads) {
+  std::vector<Verdict> verdicts(jobs.size());
+  // Every job writes only its own verdict, so nothing has to be locked.
+  parallelFor(jobs.size(), threads, [&](size_t job, size_t) {
+    verdicts[job] = verifySolution(jobs[job].instance, jobs[job].solution);
+  });
+  return verdicts;
+}
+
+// ____________________________________________________________________________
+const char* resultName(Verdict::Result result) {
+  switch (result) {
+    case Verdict::CORRECT:
+      return "correct";
+    case Verdict::WRONG:
+      return "wrong";
+    default:
+      return "invalid";
+  }
+}
@@ -0,0 +1,41 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef VERIFIER_H_
+#define VERIFIER_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// The result of checking one solution file against its instance.
+struct Verdict {
+  enum Result { CORRECT, WRONG, INVALID };
+  Result result;
+  // What is wrong (empty if the solution is correct).
+  std::string message;
+  // Amount of isles of the instance.
+  size_t isles;
+};
+
+// One solution file and the instance it belongs to.
+struct VerifyJob {
+  std::string instance;
+  std::string solution;
+};
+
+// Checks the solution file against the instance with the rules of the game,
+// without ncurses: INVALID if one of the files can't be read or a bridge
+// isn't allowed, WRONG if the bridges are fine, but don't solve the puzzle.
+Verdict verifySolution(const std::string& instance,
+                       const std::string& solution);
+
+// Checks all jobs on threads threads. The verdicts are in the order of the
+// jobs.
+std::vector<Verdict> verifyAll(const std::vector<VerifyJob>& jobs,
+                               size_t threads);
+
+// Returns "correct", "wrong" or "invalid".
+const char* resultName(Verdict::Result result);
+
+#endif  // VERIFIER_H_
@@ -0,0 +1,89 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <glob.h>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "./Parallel.h"
+#include "./Puzzle.h"
+#include "./Solver.h"
+#include "./Verifier.h"
+
+// ____________________________________________________________________________
+TEST(VerifierTest, verifySolution) {
+  const char* solution = "/tmp/VerifierTest.solution";
+  FILE* file = fopen(solution, "w");
+  fprintf(file, "0,0,9,0\n0,0,9,0\n0,0,0,7\n9,0,9,3\n0,7,12,7\n");
+  fclose(file);
+  Verdict verdict = verifySolution("i018-n005-s13x08.xy", solution);
+  ASSERT_EQ(Verdict::CORRECT, verdict.result);
+  ASSERT_EQ(5u, verdict.isles);
+  file = fopen(solution, "w");
+  fprintf(file, "0,0,9,0\n");
+  fclose(file);
+  verdict = verifySolution("i018-n005-s13x08.xy", solution);
+  ASSERT_EQ(Verdict::WRONG, verdict.result);
+  file = fopen(solution, "w");
+  fprintf(file, "0,0,12,7\n");
+  fclose(file);
+  verdict = verifySolution("i018-n005-s13x08.xy", solution);
+  ASSERT_EQ(Verdict::INVALID, verdict.result);
+  ASSERT_EQ(solution + std::string(":1: not orthogonal: 0,0,12,7"),
+            verdict.message);
+  verdict = verifySolution("does-not-exist.xy", solution);
+  ASSERT_EQ(Verdict::INVALID, verdict.result);
+  remove(solution);
+}
+
+// ____________________________________________________________________________
+TEST(VerifierTest, verifyAll) {
+  // Solve every instance, then check all solutions on several threads, with
+  // every other one checked against the 13x8 instance.
+  glob_t files;
+  ASSERT_EQ(0, glob("i0*.xy", 0, NULL, &files));
+  std::vector<VerifyJob> jobs;
+  for (size_t k = 0; k < files.gl_pathc; k++) {
+    Puzzle puzzle;
+    std::string error;
+    ASSERT_TRUE(puzzle.load(files.gl_pathv[k], &error));
+    Solver solver(puzzle);
+    ASSERT_TRUE(solver.solve());
+    VerifyJob job;
+    job.instance = files.gl_pathv[k];
+    job.solution = "/tmp/VerifierTest-" + std::to_string(k) + ".solution";
+    ASSERT_TRUE(solver.writeSolution(job.solution, &error));
+    jobs.push_back(job);
+  }
+  globfree(&files);
+  std::vector<VerifyJob> mixed = jobs;
+  for (size_t k = 1; k < mixed.size(); k += 2) {
+    mixed[k].instance = "i018-n005-s13x08.xy";
+  }
+  std::vector<Verdict> verdicts = verifyAll(jobs, 4);
+  std::vector<Verdict> wrong = verifyAll(mixed, 4);
+  ASSERT_EQ(jobs.size(), verdicts.size());
+  for (size_t k = 0; k < jobs.size(); k++) {
+    ASSERT_EQ(Verdict::CORRECT, verdicts[k].result) << jobs[k].instance;
+    ASSERT_EQ(mixed[k].instance == jobs[k].instance,
+              wrong[k].result == Verdict::CORRECT) << jobs[k].instance;
+    remove(jobs[k].solution.c_str());
+  }
+}
+
+// ____________________________________________________________________________
+TEST(VerifierTest, parallelFor) {
+  std::vector<int> done(1000, 0);
+  std::vector<size_t> perWorker(3, 0);
+  parallelFor(done.size(), 3, [&](size_t job, size_t worker) {
+    done[job]++;
+    perWorker[worker]++;
+  });
+  for (int count : done) { ASSERT_EQ(1, count); }
+  ASSERT_EQ(1000u, perWorker[0] + perWorker[1] + perWorker[2]);
+  ASSERT_LE(1u, hardwareThreads());
+  // Nothing to do is fine as well.
+  parallelFor(0, 3, [&](size_t, size_t) { done[0]++; });
+  ASSERT_EQ(1, done[0]);
+}
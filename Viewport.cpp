@@ -0,0 +1,122 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include "./Viewport.h"
+
+const int Viewport::kMinSpacing;
+const int Viewport::kMaxSpacing;
+
+// ____________________________________________________________________________
+Viewport::Viewport() {
+  _boardWidth = 0;
+  _boardHeight = 0;
+  _screenWidth = 0;
+  _screenHeight = 0;
+  _originX = 0;
+  _originY = 0;
+  _spacing = 5;
+}
+
+// ____________________________________________________________________________
+void Viewport::setBoard(size_t width, size_t height) {
+  _boardWidth = width;
+  _boardHeight = height;
+  _originX = 0;
+  _originY = 0;
+}
+
+// ____________________________________________________________________________
+void Viewport::setScreen(size_t width, size_t height) {
+  _screenWidth = width;
+  _screenHeight = height;
+}
+
+// ____________________________________________________________________________
+size_t Viewport::fullWidth() const {
+  return _boardWidth * _spacing + isleRadius() + 1;
+}
+
+// ____________________________________________________________________________
+size_t Viewport::fullHeight() const {
+  return _boardHeight * _spacing + isleRadius() + 1;
+}
+
+// ____________________________________________________________________________
+bool Viewport::pan(int dx, int dy) {
+  size_t oldX = _originX;
+  size_t oldY = _originY;
+  long x = static_cast<long>(_originX) + dx;
+  long y = static_cast<long>(_originY) + dy;
+  long maxX = _boardWidth > 0 ? _boardWidth - 1 : 0;
+  long maxY = _boardHeight > 0 ? _boardHeight - 1 : 0;
+  _originX = std::max(0L, std::min(x, maxX));
+  _originY = std::max(0L, std::min(y, maxY));
+  return _originX != oldX || _originY != oldY;
+}
+
+// ____________________________________________________________________________
+bool Viewport::zoom(int delta) {
+  int old = _spacing;
+  _spacing = std::max(kMinSpacing, std::min(_spacing + delta, kMaxSpacing));
+  return _spacing != old;
+}
+
+// ____________________________________________________________________________
+int Viewport::getSpacing() const { return _spacing; }
+
+// ____________________________________________________________________________
+int Viewport::isleRadius() const {
+  // A 3x3 block needs at least one free cell to the next one.
+  return _spacing >= 4 ? 1 : 0;
+}
+
+// ____________________________________________________________________________
+long Viewport::screenX(size_t x) const {
+  return (static_cast<long>(x) - static_cast<long>(_originX) + 1) * _spacing;
+}
+
+// ____________________________________________________________________________
+long Viewport::screenY(size_t y) const {
+  return (static_cast<long>(y) - static_cast<long>(_originY) + 1) * _spacing;
+}
+
+// ____________________________________________________________________________
+bool Viewport::toGrid(long x, long y, size_t* gridX, size_t* gridY) const {
+  // The nearest grid position, then check whether its isle covers (x, y).
+  long gx = (x + _spacing / 2) / _spacing - 1 + static_cast<long>(_originX);
+  long gy = (y + _spacing / 2) / _spacing - 1 + static_cast<long>(_originY);
+  if (x < 0 || y < 0 || gx < 0 || gy < 0) { return false; }
+  if (labs(screenX(gx) - x) > isleRadius() ||
+      labs(screenY(gy) - y) > isleRadius()) {
+    return false;
+  }
+  *gridX = gx;
+  *gridY = gy;
+  return true;
+}
+
+// ____________________________________________________________________________
+size_t Viewport::firstX() const {
+  // The column left of the origin is drawn at 0, so it is still visible.
+  return _originX > 0 ? _originX - 1 : 0;
+}
+
+// ____________________________________________________________________________
+size_t Viewport::endX() const {
+  // Everything whose isle reaches into the screen.
+  size_t columns = (_screenWidth + isleRadius()) / _spacing;
+  return std::min(_boardWidth, _originX + columns);
+}
+
+// ____________________________________________________________________________
+size_t Viewport::firstY() const {
+  return _originY > 0 ? _originY - 1 : 0;
+}
+
+// ____________________________________________________________________________
+size_t Viewport::endY() const {
+  size_t rows = (_screenHeight + isleRadius()) / _spacing;
+  return std::min(_boardHeight, _originY + rows);
+}
@@ -0,0 +1,74 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#ifndef VIEWPORT_H_
+#define VIEWPORT_H_
+
+#include <stdio.h>
+
+// Maps grid positions of the board to cells of the screen and back. Grid
+// position (x, y) is drawn at ((x - originX + 1) * spacing, (y - originY + 1)
+// * spacing), so the origin scrolls and the spacing zooms the board.
+class Viewport {
+ public:
+  // Constructor.
+  Viewport();
+
+  // Sets the size of the board in grid positions.
+  void setBoard(size_t width, size_t height);
+
+  // Sets the size of the screen in cells.
+  void setScreen(size_t width, size_t height);
+
+  // Returns the size of the screen needed to show the whole board.
+  size_t fullWidth() const;
+  size_t fullHeight() const;
+
+  // Scrolls: moves the origin by (dx, dy) grid positions, it stays on the
+  // board. Returns false if nothing changed.
+  bool pan(int dx, int dy);
+
+  // Changes the spacing by delta (between kMinSpacing and kMaxSpacing).
+  // Returns false if nothing changed.
+  bool zoom(int delta);
+
+  // Returns the distance of two grid positions on the screen.
+  int getSpacing() const;
+
+  // Returns how many cells an isle reaches around its center: 1 for the
+  // 3x3 blocks, 0 if the board is zoomed out too far for them.
+  int isleRadius() const;
+
+  // Returns the screen column of grid column x (row of grid row y). It can
+  // be outside of the screen.
+  long screenX(size_t x) const;
+  long screenY(size_t y) const;
+
+  // Finds the grid position whose isle would cover the screen cell (x, y).
+  // Returns false if there is none.
+  bool toGrid(long x, long y, size_t* gridX, size_t* gridY) const;
+
+  // The visible grid columns are [firstX(), endX()), rows the same.
+  size_t firstX() const;
+  size_t endX() const;
+  size_t firstY() const;
+  size_t endY() const;
+
+  static const int kMinSpacing = 2;
+  static const int kMaxSpacing = 8;
+
+ private:
+  // Board and screen size.
+  size_t _boardWidth;
+  size_t _boardHeight;
+  size_t _screenWidth;
+  size_t _screenHeight;
+
+  // Top left grid position on the screen.
+  size_t _originX;
+  size_t _originY;
+
+  int _spacing;
+};
+
+#endif  // VIEWPORT_H_
@@ -0,0 +1,43 @@
+// Copyright: Tom Krebs 2018
+// Mail: <tomkre13@gmail.com>
+
+#include <gtest/gtest.h>
+#include "./Viewport.h"
+
+// ____________________________________________________________________________
+TEST(ViewportTest, projection) {
+  Viewport viewport;
+  viewport.setBoard(13, 8);
+  viewport.setScreen(80, 24);
+  // Same layout as the old 5 * (x + 1).
+  ASSERT_EQ(5, viewport.screenX(0));
+  ASSERT_EQ(40, viewport.screenY(7));
+  size_t x;
+  size_t y;
+  ASSERT_TRUE(viewport.toGrid(46, 21, &x, &y));
+  ASSERT_EQ(8u, x);
+  ASSERT_EQ(3u, y);
+  ASSERT_FALSE(viewport.toGrid(47, 20, &x, &y));
+  ASSERT_FALSE(viewport.toGrid(2, 2, &x, &y));
+  // 80x24 cells show the columns 0..15 (clipped to the board) and rows 0..4.
+  ASSERT_EQ(13u, viewport.endX());
+  ASSERT_EQ(5u, viewport.endY());
+}
+
+// ____________________________________________________________________________
+TEST(ViewportTest, panAndZoom) {
+  Viewport viewport;
+  viewport.setBoard(100, 100);
+  viewport.setScreen(80, 24);
+  ASSERT_FALSE(viewport.pan(-1, 0));
+  ASSERT_TRUE(viewport.pan(10, 200));
+  ASSERT_EQ(9u, viewport.firstX());
+  ASSERT_EQ(100u, viewport.endY());
+  ASSERT_EQ(5, viewport.screenX(10));
+  ASSERT_TRUE(viewport.zoom(-10));
+  ASSERT_EQ(Viewport::kMinSpacing, viewport.getSpacing());
+  ASSERT_EQ(0, viewport.isleRadius());
+  ASSERT_FALSE(viewport.zoom(-1));
+  ASSERT_TRUE(viewport.zoom(10));
+  ASSERT_EQ(Viewport::kMaxSpacing, viewport.getSpacing());
+}